@@ -0,0 +1,37 @@
+#include "aleatorio.h"
+
+// splitmix64: espalha semente e fluxo para que estados vizinhos nao se correlacionem
+static uint64_t misturar(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+void aleatorio_semear(Aleatorio* a, uint64_t semente, uint64_t fluxo)
+{
+    a->s = misturar(semente ^ misturar(fluxo));
+    if (a->s == 0)
+        a->s = 0x9E3779B97F4A7C15ULL;   // xorshift nao pode ter estado nulo
+}
+
+uint64_t aleatorio_proximo(Aleatorio* a)
+{
+    uint64_t x = a->s;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    a->s = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+int aleatorio_inteiro(Aleatorio* a, int n)
+{
+    return (int)((aleatorio_proximo(a) >> 32) * (uint64_t)n >> 32);
+}
+
+double aleatorio_uniforme(Aleatorio* a)
+{
+    return (aleatorio_proximo(a) >> 11) * (1.0 / 9007199254740992.0);
+}
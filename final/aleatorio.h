@@ -0,0 +1,25 @@
+#ifndef ALEATORIO_H
+#define ALEATORIO_H
+
+#include <stdint.h>
+
+/* === GERADOR PSEUDOALEATORIO (xorshift64*) === */
+// Estado explicito, ao contrario de rand(): pode ser salvo, restaurado e
+// mantido por thread, sem disputa entre produtores
+typedef struct
+{
+    uint64_t s;
+} Aleatorio;
+
+// Semeia o gerador; fluxos diferentes da mesma semente sao independentes
+void aleatorio_semear(Aleatorio* a, uint64_t semente, uint64_t fluxo);
+
+uint64_t aleatorio_proximo(Aleatorio* a);
+
+// Inteiro uniforme em [0, n)
+int aleatorio_inteiro(Aleatorio* a, int n);
+
+// Real uniforme em [0, 1)
+double aleatorio_uniforme(Aleatorio* a);
+
+#endif
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include "antecipacao.h"
+
+#define TRUE 1
+#define FALSE 0
+
+
+/* === VARIAVEIS GLOBAIS === */
+// Pool: cada rodada publica uma decisao; as threads (e quem decide) retiram candidatos
+// por um indice atomico, e a ultima a sair da rodada acorda quem decide
+static pthread_t* threads = NULL;
+static int n_extras = 0;
+static pthread_mutex_t mutex_pool = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t mutex_decisao = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond_rodada = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t cond_concluida = PTHREAD_COND_INITIALIZER;
+static DecisaoAntecipacao* decisao = NULL;
+static unsigned long rodada = 0;
+static int proximo_candidato = 0;
+static int ativas = 0;
+static int encerrar = FALSE;
+
+
+/* === ROLLOUT === */
+static double viagem(const DecisaoAntecipacao* d, int k, int de, int para)
+{
+    return fabs(d->cotas[para] - d->cotas[de]) / d->modelos[k].velocidade + d->modelos[k].tempo_porta;
+}
+
+// Mesmo modelo do cache de ETA: o carro parte quando fica livre e atende em sequencia.
+// Retorna a espera do passageiro ate o embarque.
+static double atribuir(const DecisaoAntecipacao* d, FrotaCompacta* f, int k, double instante, int origem, int destino)
+{
+    double partida = f->t_livre[k] > instante ? f->t_livre[k] : instante;
+    double embarque = partida + viagem(d, k, f->andar_livre[k], origem);
+    f->t_livre[k] = embarque + viagem(d, k, origem, destino);
+    f->andar_livre[k] = destino;
+    return embarque - instante;
+}
+
+// Espera total da chamada e das chegadas previstas com a chamada no candidato c, mais o
+// trabalho pendente apos o horizonte (quem so adia a espera para depois dele nao ganha)
+static double simular(const DecisaoAntecipacao* d, int c)
+{
+    FrotaCompacta f = d->frota;
+    double espera = atribuir(d, &f, d->candidatos[c], d->agora, d->origem, d->destino);
+
+    for (int i = 0; i < d->n_chegadas; i++) {
+        const ChegadaPrevista* ch = &d->chegadas[i];
+        int melhor = 0;
+        double menor = 0;
+        for (int k = 0; k < d->n_carros; k++) {
+            double partida = f.t_livre[k] > ch->instante ? f.t_livre[k] : ch->instante;
+            double embarque = partida + viagem(d, k, f.andar_livre[k], ch->origem);
+            if (k == 0 || embarque < menor) {
+                menor = embarque;
+                melhor = k;
+            }
+        }
+        espera += atribuir(d, &f, melhor, ch->instante, ch->origem, ch->destino);
+    }
+    for (int k = 0; k < d->n_carros; k++)
+        if (f.t_livre[k] > d->fim)
+            espera += f.t_livre[k] - d->fim;
+    return espera;
+}
+
+static void avaliar_candidatos(DecisaoAntecipacao* d)
+{
+    while (TRUE) {
+        int c = __atomic_fetch_add(&proximo_candidato, 1, __ATOMIC_RELAXED);
+        if (c >= d->n_candidatos)
+            break;
+        d->espera[c] = simular(d, c);
+    }
+}
+
+
+/* === POOL DE THREADS === */
+static void* funcao_rollout(void* arg)
+{
+    unsigned long vista = 0;
+    while (TRUE) {
+        pthread_mutex_lock(&mutex_pool);
+        while (!encerrar && rodada == vista)
+            pthread_cond_wait(&cond_rodada, &mutex_pool);
+        if (encerrar) {
+            pthread_mutex_unlock(&mutex_pool);
+            break;
+        }
+        vista = rodada;
+        DecisaoAntecipacao* d = decisao;
+        pthread_mutex_unlock(&mutex_pool);
+
+        avaliar_candidatos(d);
+
+        pthread_mutex_lock(&mutex_pool);
+        if (--ativas == 0)
+            pthread_cond_signal(&cond_concluida);
+        pthread_mutex_unlock(&mutex_pool);
+    }
+    return NULL;
+}
+
+int antecipacao_iniciar(int n_threads)
+{
+    n_extras = n_threads > 1 ? n_threads - 1 : 0;
+    if (n_extras == 0)
+        return TRUE;
+    threads = malloc(n_extras * sizeof(pthread_t));
+    if (threads == NULL) {
+        printf("Erro: sem memoria para o pool de rollouts\n");
+        n_extras = 0;
+        return FALSE;
+    }
+    encerrar = FALSE;
+    for (int i = 0; i < n_extras; i++) {
+        if (pthread_create(&threads[i], NULL, funcao_rollout, NULL) != 0) {
+            printf("Erro: nao foi possivel criar a thread %d do pool de rollouts\n", i);
+            n_extras = i;
+            antecipacao_finalizar();
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+void antecipacao_finalizar(void)
+{
+    pthread_mutex_lock(&mutex_pool);
+    encerrar = TRUE;
+    pthread_cond_broadcast(&cond_rodada);
+    pthread_mutex_unlock(&mutex_pool);
+    for (int i = 0; i < n_extras; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+    threads = NULL;
+    n_extras = 0;
+}
+
+int antecipacao_decidir(DecisaoAntecipacao* d)
+{
+    pthread_mutex_lock(&mutex_decisao);
+    proximo_candidato = 0;
+    if (n_extras > 0 && d->n_candidatos > 1) {
+        // Todas as threads passam pela rodada: a decisao so e liberada depois da ultima
+        pthread_mutex_lock(&mutex_pool);
+        decisao = d;
+        ativas = n_extras;
+        rodada++;
+        pthread_cond_broadcast(&cond_rodada);
+        pthread_mutex_unlock(&mutex_pool);
+
+        avaliar_candidatos(d);
+
+        pthread_mutex_lock(&mutex_pool);
+        while (ativas > 0)
+            pthread_cond_wait(&cond_concluida, &mutex_pool);
+        pthread_mutex_unlock(&mutex_pool);
+    } else {
+        avaliar_candidatos(d);
+    }
+    pthread_mutex_unlock(&mutex_decisao);
+
+    int melhor = 0;
+    for (int c = 1; c < d->n_candidatos; c++)
+        if (d->espera[c] < d->espera[melhor])
+            melhor = c;
+    return melhor;
+}
@@ -0,0 +1,61 @@
+#ifndef ANTECIPACAO_H
+#define ANTECIPACAO_H
+
+#include "eta.h"
+
+/* === DESPACHO POR ANTECIPACAO (rollouts) === */
+// Para cada chamada, cada elevador candidato recebe uma copia do estado compacto da
+// frota da zona, e o modelo avanca o horizonte com as chegadas previstas (as mesmas
+// para todos os candidatos, despachadas pelo menor ETA). Vence o candidato de menor
+// custo: espera total mais o trabalho que a frota ainda deve depois do horizonte.
+// O estado clonado e plano (vetores, sem ponteiros). Clonar e apenas copiar.
+//
+// Os rollouts de uma decisao sao independentes e rodam num pool de threads. O resultado
+// nao depende do numero de threads.
+#define ANTECIPACAO_MAX_CARROS 128      // Elevadores da zona; acima disso o despacho e guloso
+#define ANTECIPACAO_MAX_CHEGADAS 512    // Chamadas previstas no horizonte
+#define ANTECIPACAO_MAX_CANDIDATOS 8    // Candidatos avaliados (os de menor ETA)
+
+// Estado compacto da frota de uma zona: o que muda num rollout
+typedef struct
+{
+    double t_livre[ANTECIPACAO_MAX_CARROS];
+    int andar_livre[ANTECIPACAO_MAX_CARROS];
+} FrotaCompacta;
+
+typedef struct
+{
+    double instante;
+    int origem;
+    int destino;            // Fim do trecho na zona
+} ChegadaPrevista;
+
+// Uma decisao: frota, chamada a despachar, chegadas previstas e candidatos
+typedef struct
+{
+    int n_carros;
+    FrotaCompacta frota;
+    ModeloViagem modelos[ANTECIPACAO_MAX_CARROS];
+    const double* cotas;            // Modelo do edificio (somente leitura)
+
+    double agora;
+    double fim;                     // Fim do horizonte
+    int origem;
+    int destino;
+    int n_chegadas;                 // Em ordem de instante
+    ChegadaPrevista chegadas[ANTECIPACAO_MAX_CHEGADAS];
+
+    int n_candidatos;               // Indices na frota, em ordem de ETA
+    int candidatos[ANTECIPACAO_MAX_CANDIDATOS];
+    double espera[ANTECIPACAO_MAX_CANDIDATOS];  // Saida: custo de cada rollout
+} DecisaoAntecipacao;
+
+// Pool de n_threads (contando a que decide; 1 = sem threads extras). Retorna FALSE em erro.
+int antecipacao_iniciar(int n_threads);
+void antecipacao_finalizar(void);
+
+// Executa um rollout por candidato e retorna a posicao (em candidatos[]) do de menor
+// custo; no empate, o de menor ETA. Uma decisao por vez no processo.
+int antecipacao_decidir(DecisaoAntecipacao* d);
+
+#endif
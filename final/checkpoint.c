@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <string.h>
+#include "checkpoint.h"
+
+#define TRUE 1
+#define FALSE 0
+
+static const char MAGICO[8] = {'E', 'L', 'E', 'V', 'C', 'K', 'P', '\0'};
+
+
+/* === SOMA DE VERIFICACAO === */
+static uint32_t fnv1a(uint32_t h, const void* dados, size_t tamanho)
+{
+    const unsigned char* p = dados;
+    for (size_t i = 0; i < tamanho; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+
+/* === ESCRITA === */
+int checkpoint_abrir_escrita(Checkpoint* c, const char* caminho)
+{
+    c->f = fopen(caminho, "wb");
+    c->soma = 2166136261u;
+    c->erro = c->f == NULL;
+    if (c->erro) {
+        printf("Erro: nao foi possivel criar o checkpoint %s\n", caminho);
+        return FALSE;
+    }
+    uint32_t versao = CHECKPOINT_VERSAO;
+    fwrite(MAGICO, sizeof(MAGICO), 1, c->f);
+    fwrite(&versao, sizeof(versao), 1, c->f);
+    return TRUE;
+}
+
+void checkpoint_escrever(Checkpoint* c, const void* dados, size_t tamanho)
+{
+    if (c->erro || tamanho == 0)
+        return;
+    if (fwrite(dados, tamanho, 1, c->f) != 1)
+        c->erro = TRUE;
+    c->soma = fnv1a(c->soma, dados, tamanho);
+}
+
+int checkpoint_fechar_escrita(Checkpoint* c)
+{
+    if (c->f == NULL)
+        return FALSE;
+    if (!c->erro && fwrite(&c->soma, sizeof(c->soma), 1, c->f) != 1)
+        c->erro = TRUE;
+    if (fclose(c->f) != 0)
+        c->erro = TRUE;
+    c->f = NULL;
+    return !c->erro;
+}
+
+
+/* === LEITURA === */
+int checkpoint_abrir_leitura(Checkpoint* c, const char* caminho)
+{
+    c->f = fopen(caminho, "rb");
+    c->soma = 2166136261u;
+    c->erro = c->f == NULL;
+    if (c->erro) {
+        printf("Erro: nao foi possivel abrir o checkpoint %s\n", caminho);
+        return FALSE;
+    }
+
+    char magico[sizeof(MAGICO)];
+    uint32_t versao;
+    if (fread(magico, sizeof(magico), 1, c->f) != 1 || memcmp(magico, MAGICO, sizeof(MAGICO)) != 0
+        || fread(&versao, sizeof(versao), 1, c->f) != 1 || versao != CHECKPOINT_VERSAO) {
+        printf("Erro: %s nao e um checkpoint compativel (versao %d)\n", caminho, CHECKPOINT_VERSAO);
+        fclose(c->f);
+        c->f = NULL;
+        c->erro = TRUE;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void checkpoint_ler(Checkpoint* c, void* dados, size_t tamanho)
+{
+    if (c->erro || tamanho == 0)
+        return;
+    if (fread(dados, tamanho, 1, c->f) != 1) {
+        c->erro = TRUE;
+        return;
+    }
+    c->soma = fnv1a(c->soma, dados, tamanho);
+}
+
+int checkpoint_fechar_leitura(Checkpoint* c)
+{
+    if (c->f == NULL)
+        return FALSE;
+    uint32_t soma;
+    if (!c->erro && (fread(&soma, sizeof(soma), 1, c->f) != 1 || soma != c->soma)) {
+        printf("Erro: checkpoint corrompido (soma de verificacao nao confere)\n");
+        c->erro = TRUE;
+    }
+    fclose(c->f);
+    c->f = NULL;
+    return !c->erro;
+}
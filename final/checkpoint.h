@@ -0,0 +1,29 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* === ARQUIVO BINARIO DE CHECKPOINT === */
+// Cabecalho fixo + blocos brutos gravados na ordem em que sao lidos + soma de verificacao.
+// O formato assume a mesma arquitetura na gravacao e na leitura.
+#define CHECKPOINT_VERSAO 4
+
+typedef struct
+{
+    FILE* f;
+    uint32_t soma;  // FNV-1a de todos os blocos
+    int erro;
+} Checkpoint;
+
+int checkpoint_abrir_escrita(Checkpoint* c, const char* caminho);
+int checkpoint_abrir_leitura(Checkpoint* c, const char* caminho);
+
+void checkpoint_escrever(Checkpoint* c, const void* dados, size_t tamanho);
+void checkpoint_ler(Checkpoint* c, void* dados, size_t tamanho);
+
+// Na escrita grava a soma; na leitura confere. Retorna FALSE se houve qualquer erro.
+int checkpoint_fechar_escrita(Checkpoint* c);
+int checkpoint_fechar_leitura(Checkpoint* c);
+
+#endif
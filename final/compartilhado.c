@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "compartilhado.h"
+
+#define TRUE 1
+#define FALSE 0
+
+
+/* === VARIAVEIS GLOBAIS === */
+static SegmentoCompartilhado* segmento = NULL;
+static size_t tamanho_mapeado = 0;
+static char nome_segmento[256];
+
+
+/* === CICLO DE VIDA === */
+// nome segue shm_open: "/nome", visivel em /dev/shm/nome no Linux
+int compartilhado_iniciar(const char* nome, int n_andares, int n_elevadores, int64_t epoca_ns, double escala)
+{
+    if (nome[0] != '/' || strlen(nome) >= sizeof(nome_segmento)) {
+        printf("Erro: nome do segmento compartilhado deve comecar com '/': %s\n", nome);
+        return FALSE;
+    }
+
+    size_t tamanho_segmento = sizeof(SegmentoCompartilhado) + n_elevadores * sizeof(SlotElevador);
+    int fd = shm_open(nome, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, tamanho_segmento) != 0) {
+        printf("Erro: nao foi possivel criar o segmento compartilhado %s\n", nome);
+        if (fd >= 0) {
+            close(fd);
+            shm_unlink(nome);
+        }
+        return FALSE;
+    }
+    segmento = mmap(NULL, tamanho_segmento, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segmento == MAP_FAILED) {
+        printf("Erro: nao foi possivel mapear o segmento compartilhado %s\n", nome);
+        segmento = NULL;
+        shm_unlink(nome);
+        return FALSE;
+    }
+    strcpy(nome_segmento, nome);
+    tamanho_mapeado = tamanho_segmento;
+
+    segmento->versao = COMPARTILHADO_VERSAO;
+    segmento->n_andares = n_andares;
+    segmento->n_elevadores = n_elevadores;
+    segmento->epoca_ns = epoca_ns;
+    segmento->escala = escala > 0 ? escala : 1.0;
+    segmento->ativo = TRUE;
+    // Magico por ultimo: leitores que o encontram veem o cabecalho completo
+    __atomic_store_n(&segmento->magico, COMPARTILHADO_MAGICO, __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+// Leitores ja conectados continuam com o mapeamento deles; o nome deixa de existir.
+// Chamado depois do join de todas as threads da simulacao: ninguem mais publica, e o
+// mapeamento do simulador pode ser desfeito.
+void compartilhado_finalizar(void)
+{
+    if (segmento == NULL)
+        return;
+    __atomic_store_n(&segmento->ativo, FALSE, __ATOMIC_RELEASE);
+    shm_unlink(nome_segmento);
+    munmap(segmento, tamanho_mapeado);
+    segmento = NULL;
+}
+
+int compartilhado_ativo(void)
+{
+    return segmento != NULL;
+}
+
+
+/* === PUBLICACAO === */
+void compartilhado_publicar(int id, const EstadoElevador* estado)
+{
+    SlotElevador* slot = &segmento->elevadores[id];
+    int32_t palavras[COMPARTILHADO_PALAVRAS];
+    memcpy(palavras, estado, sizeof(*estado));
+
+    uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (unsigned i = 0; i < COMPARTILHADO_PALAVRAS; i++)
+        __atomic_store_n(&slot->palavras[i], palavras[i], __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+}
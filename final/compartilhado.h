@@ -0,0 +1,71 @@
+#ifndef COMPARTILHADO_H
+#define COMPARTILHADO_H
+
+#include <stdint.h>
+#include <string.h>
+
+/* === ESTADO DA FROTA EM MEMORIA COMPARTILHADA (POSIX shm + seqlock) === */
+// Cada elevador tem um slot com contador de sequencia: o escritor o torna impar,
+// grava o estado e o torna par de novo. O leitor repete a leitura ate obter duas
+// sequencias pares iguais. Leitores nunca bloqueiam o simulador.
+#define COMPARTILHADO_MAGICO 0x56454c45     // "ELEV"
+#define COMPARTILHADO_VERSAO 2
+#define COMPARTILHADO_MAX_PARADAS 18
+
+typedef struct
+{
+    int32_t andar;          // Ultimo andar alcancado
+    int32_t destino;        // Andar do trecho em curso (igual a andar se parado)
+    int32_t direcao;        // 1 sobe, -1 desce, 0 parado
+    int32_t partida_ms;     // Inicio do trecho em curso (relogio da simulacao)
+    int32_t chegada_ms;     // Fim previsto do trecho, com o ciclo de portas
+    int32_t carga;          // Passageiros a bordo
+    int32_t atendidas;
+    int32_t n_paradas;
+    int32_t paradas[COMPARTILHADO_MAX_PARADAS];    // Proximas paradas, em ordem
+} EstadoElevador;
+
+#define COMPARTILHADO_PALAVRAS (sizeof(EstadoElevador) / sizeof(int32_t))
+
+typedef struct
+{
+    uint32_t seq;
+    int32_t palavras[COMPARTILHADO_PALAVRAS];
+} __attribute__((aligned(64))) SlotElevador;
+
+typedef struct
+{
+    uint32_t magico;
+    uint32_t versao;
+    int32_t n_andares;
+    int32_t n_elevadores;
+    int64_t epoca_ns;       // CLOCK_MONOTONIC da epoca: relogio = (agora - epoca) / escala
+    double escala;          // Segundos reais por segundo da simulacao (1: tempo real)
+    uint32_t ativo;         // Zerado quando a simulacao termina
+    SlotElevador elevadores[];
+} SegmentoCompartilhado;
+
+// Lado do simulador
+int compartilhado_iniciar(const char* nome, int n_andares, int n_elevadores, int64_t epoca_ns, double escala);
+void compartilhado_finalizar(void);
+int compartilhado_ativo(void);
+
+// Os escritores de um mesmo elevador devem estar serializados entre si
+void compartilhado_publicar(int id, const EstadoElevador* estado);
+
+// Lado do leitor: copia um retrato consistente do slot
+static inline void compartilhado_ler(const SlotElevador* slot, EstadoElevador* estado)
+{
+    int32_t palavras[COMPARTILHADO_PALAVRAS];
+    uint32_t antes, depois;
+    do {
+        antes = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        for (unsigned i = 0; i < COMPARTILHADO_PALAVRAS; i++)
+            palavras[i] = __atomic_load_n(&slot->palavras[i], __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        depois = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+    } while ((antes & 1) || antes != depois);
+    memcpy(estado, palavras, sizeof(*estado));
+}
+
+#endif
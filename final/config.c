@@ -0,0 +1,595 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include "config.h"
+#include "zonas.h"
+
+#define TRUE 1
+#define FALSE 0
+#define TAM_LINHA 512
+
+
+/* === ESTADO DO LEITOR === */
+enum { SECAO_NENHUMA, SECAO_PREDIO, SECAO_ELEVADOR, SECAO_ZONA, SECAO_TRAFEGO, SECAO_POLITICA };
+
+typedef struct
+{
+    const char* caminho;
+    int linha;
+    int secao;
+
+    // Secao [elevador] em andamento (replicada "quantidade" vezes ao fechar)
+    ConfigElevador elevador;
+    int quantidade;
+
+    // Secao [zona] em andamento
+    ConfigZona zona;
+    int* ids;
+    int n_ids;
+    int zona_tem_andares;
+
+    // Alturas entre andares consecutivos, validadas ao final
+    double* alturas;
+    int n_alturas;
+    int linha_alturas;
+    int linha_andares;
+
+    // Linhas das chaves de [trafego] e [politica] (0 se padrao), validadas ao final
+    int linha_intervalo_min;
+    int linha_intervalo_max;
+    int linha_fator_pico;
+    int linha_periodo;
+
+    int cap_elevadores;
+    int cap_zonas;
+    int cap_ids_zonas;
+} Leitor;
+
+
+/* === MENSAGENS DE ERRO === */
+static int erro(const char* caminho, int linha, const char* msg, const char* detalhe)
+{
+    if (linha > 0)
+        printf("Erro: %s:%d: %s%s\n", caminho, linha, msg, detalhe);
+    else
+        printf("Erro: %s: %s%s\n", caminho, msg, detalhe);
+    return FALSE;
+}
+
+
+/* === CONVERSAO DE VALORES === */
+static char* aparar(char* s)
+{
+    while (isspace((unsigned char)*s))
+        s++;
+    char* fim = s + strlen(s);
+    while (fim > s && isspace((unsigned char)fim[-1]))
+        *--fim = '\0';
+    return s;
+}
+
+static int ler_int(const char* s, int* v)
+{
+    char* fim;
+    errno = 0;
+    long x = strtol(s, &fim, 10);
+    if (fim == s || *aparar(fim) != '\0' || errno == ERANGE || x < INT_MIN || x > INT_MAX)
+        return FALSE;
+    *v = (int)x;
+    return TRUE;
+}
+
+static int ler_double(const char* s, double* v)
+{
+    char* fim;
+    double x = strtod(s, &fim);
+    if (fim == s || *aparar(fim) != '\0')
+        return FALSE;
+    *v = x;
+    return TRUE;
+}
+
+static int ler_bool(const char* s, int* v)
+{
+    if (strcmp(s, "sim") == 0 || strcmp(s, "true") == 0 || strcmp(s, "1") == 0) {
+        *v = TRUE;
+        return TRUE;
+    }
+    if (strcmp(s, "nao") == 0 || strcmp(s, "false") == 0 || strcmp(s, "0") == 0) {
+        *v = FALSE;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+// Faixa "a-b" ou andar unico "a"
+static int ler_faixa(const char* s, int* min, int* max)
+{
+    char tmp[TAM_LINHA];
+    snprintf(tmp, sizeof(tmp), "%s", s);
+    char* hifen = strchr(tmp, '-');
+    if (hifen == NULL) {
+        if (!ler_int(aparar(tmp), min))
+            return FALSE;
+        *max = *min;
+        return TRUE;
+    }
+    *hifen = '\0';
+    return ler_int(aparar(tmp), min) && ler_int(aparar(hifen + 1), max) && *min <= *max;
+}
+
+// Lista de faixas separadas por virgula, ex.: "0-3, 8"
+static int ler_lista_ids(const char* s, int** ids, int* n)
+{
+    char tmp[TAM_LINHA];
+    char* resto;
+    snprintf(tmp, sizeof(tmp), "%s", s);
+    for (char* item = strtok_r(tmp, ",", &resto); item != NULL; item = strtok_r(NULL, ",", &resto)) {
+        int a, b;
+        if (!ler_faixa(aparar(item), &a, &b))
+            return FALSE;
+        for (int id = a; id <= b; id++) {
+            int* novo = realloc(*ids, (*n + 1) * sizeof(int));
+            if (novo == NULL)
+                return FALSE;
+            *ids = novo;
+            (*ids)[(*n)++] = id;
+        }
+    }
+    return TRUE;
+}
+
+// Lista de alturas com repeticao, ex.: "4.5, 3.0*19"
+static int ler_alturas(const char* s, double** alturas, int* n)
+{
+    char tmp[TAM_LINHA];
+    char* resto;
+    snprintf(tmp, sizeof(tmp), "%s", s);
+    for (char* item = strtok_r(tmp, ",", &resto); item != NULL; item = strtok_r(NULL, ",", &resto)) {
+        int repeticoes = 1;
+        char* asterisco = strchr(item, '*');
+        if (asterisco != NULL) {
+            *asterisco = '\0';
+            if (!ler_int(aparar(asterisco + 1), &repeticoes) || repeticoes < 1)
+                return FALSE;
+        }
+        double altura;
+        if (!ler_double(aparar(item), &altura))
+            return FALSE;
+
+        double* novo = realloc(*alturas, (*n + repeticoes) * sizeof(double));
+        if (novo == NULL)
+            return FALSE;
+        *alturas = novo;
+        for (int k = 0; k < repeticoes; k++)
+            (*alturas)[(*n)++] = altura;
+    }
+    return TRUE;
+}
+
+
+/* === MONTAGEM DAS TABELAS === */
+static void elevador_padrao(ConfigElevador* e)
+{
+    e->velocidade = VELOCIDADE_PADRAO;
+    e->tempo_porta = TEMPO_PORTA_PADRAO;
+    e->capacidade = CAPACIDADE_PADRAO;
+    e->andar_min = 0;
+    e->andar_max = -1;  // Ate o ultimo andar (resolvido na validacao)
+    e->linha = 0;
+}
+
+static void predio_vazio(Predio* p)
+{
+    memset(p, 0, sizeof(*p));
+    p->n_chamadas = 0;
+    p->trafego.intervalo_min = 1.0;
+    p->trafego.intervalo_max = 3.0;
+    p->trafego.perfil = PERFIL_UNIFORME;
+    p->trafego.fator_pico = 4.0;
+    p->politica.estacionamento = TRUE;
+    p->politica.periodo_estacionamento = 2.0;
+    p->politica.zonas_uniformes = 1;
+}
+
+static int adicionar_elevadores(Predio* p, Leitor* l)
+{
+    if (p->n_elevadores + l->quantidade > l->cap_elevadores) {
+        int cap = (p->n_elevadores + l->quantidade) * 2;
+        ConfigElevador* novo = realloc(p->elevadores, cap * sizeof(ConfigElevador));
+        if (novo == NULL)
+            return erro(l->caminho, l->elevador.linha, "sem memoria para a tabela de elevadores", "");
+        p->elevadores = novo;
+        l->cap_elevadores = cap;
+    }
+    for (int k = 0; k < l->quantidade; k++)
+        p->elevadores[p->n_elevadores++] = l->elevador;
+    return TRUE;
+}
+
+static int adicionar_zona(Predio* p, Leitor* l)
+{
+    if (!l->zona_tem_andares)
+        return erro(l->caminho, l->zona.linha, "zona sem a chave 'andares'", "");
+    if (l->n_ids == 0)
+        return erro(l->caminho, l->zona.linha, "zona sem a chave 'elevadores'", "");
+
+    if (p->n_zonas == l->cap_zonas) {
+        int cap = l->cap_zonas ? l->cap_zonas * 2 : 4;
+        ConfigZona* novo = realloc(p->zonas, cap * sizeof(ConfigZona));
+        if (novo == NULL)
+            return erro(l->caminho, l->zona.linha, "sem memoria para a tabela de zonas", "");
+        p->zonas = novo;
+        l->cap_zonas = cap;
+    }
+    int total_ids = 0;
+    for (int z = 0; z < p->n_zonas; z++)
+        total_ids += p->zonas[z].n_ids;
+    if (total_ids + l->n_ids > l->cap_ids_zonas) {
+        int cap = (total_ids + l->n_ids) * 2;
+        int* novo = realloc(p->ids_zonas, cap * sizeof(int));
+        if (novo == NULL)
+            return erro(l->caminho, l->zona.linha, "sem memoria para a tabela de zonas", "");
+        p->ids_zonas = novo;
+        l->cap_ids_zonas = cap;
+    }
+    memcpy(&p->ids_zonas[total_ids], l->ids, l->n_ids * sizeof(int));
+    l->zona.inicio_ids = total_ids;
+    l->zona.n_ids = l->n_ids;
+    p->zonas[p->n_zonas++] = l->zona;
+
+    free(l->ids);
+    l->ids = NULL;
+    l->n_ids = 0;
+    return TRUE;
+}
+
+// Fecha a secao atual, transferindo secoes repetiveis para as tabelas
+static int fechar_secao(Predio* p, Leitor* l)
+{
+    if (l->secao == SECAO_ELEVADOR)
+        return adicionar_elevadores(p, l);
+    if (l->secao == SECAO_ZONA)
+        return adicionar_zona(p, l);
+    return TRUE;
+}
+
+static int abrir_secao(Leitor* l, const char* nome)
+{
+    if (strcmp(nome, "predio") == 0) {
+        l->secao = SECAO_PREDIO;
+    } else if (strcmp(nome, "elevador") == 0) {
+        l->secao = SECAO_ELEVADOR;
+        elevador_padrao(&l->elevador);
+        l->elevador.linha = l->linha;
+        l->quantidade = 1;
+    } else if (strcmp(nome, "zona") == 0) {
+        l->secao = SECAO_ZONA;
+        memset(&l->zona, 0, sizeof(l->zona));
+        l->zona.linha = l->linha;
+        l->zona_tem_andares = FALSE;
+    } else if (strcmp(nome, "trafego") == 0) {
+        l->secao = SECAO_TRAFEGO;
+    } else if (strcmp(nome, "politica") == 0) {
+        l->secao = SECAO_POLITICA;
+    } else {
+        return erro(l->caminho, l->linha, "secao desconhecida: ", nome);
+    }
+    return TRUE;
+}
+
+
+/* === CHAVES DE CADA SECAO === */
+static int chave_predio(Predio* p, Leitor* l, const char* chave, const char* valor)
+{
+    if (strcmp(chave, "andares") == 0) {
+        l->linha_andares = l->linha;
+        return ler_int(valor, &p->n_andares);
+    }
+    if (strcmp(chave, "chamadas") == 0)
+        return ler_int(valor, &p->n_chamadas);
+    if (strcmp(chave, "altura") == 0 || strcmp(chave, "alturas") == 0) {
+        free(l->alturas);
+        l->alturas = NULL;
+        l->n_alturas = 0;
+        l->linha_alturas = l->linha;
+        return ler_alturas(valor, &l->alturas, &l->n_alturas);
+    }
+    return -1;
+}
+
+static int chave_elevador(Leitor* l, const char* chave, const char* valor)
+{
+    ConfigElevador* e = &l->elevador;
+    if (strcmp(chave, "quantidade") == 0)
+        return ler_int(valor, &l->quantidade) && l->quantidade >= 1;
+    if (strcmp(chave, "velocidade") == 0)
+        return ler_double(valor, &e->velocidade);
+    if (strcmp(chave, "tempo_porta") == 0)
+        return ler_double(valor, &e->tempo_porta);
+    if (strcmp(chave, "capacidade") == 0)
+        return ler_int(valor, &e->capacidade);
+    if (strcmp(chave, "andares") == 0)
+        return ler_faixa(valor, &e->andar_min, &e->andar_max);
+    return -1;
+}
+
+static int chave_zona(Leitor* l, const char* chave, const char* valor)
+{
+    if (strcmp(chave, "andares") == 0) {
+        l->zona_tem_andares = TRUE;
+        return ler_faixa(valor, &l->zona.andar_min, &l->zona.andar_max);
+    }
+    if (strcmp(chave, "transferencia") == 0)
+        return ler_int(valor, &l->zona.andar_transferencia);
+    if (strcmp(chave, "elevadores") == 0)
+        return ler_lista_ids(valor, &l->ids, &l->n_ids);
+    return -1;
+}
+
+static int chave_trafego(Predio* p, Leitor* l, const char* chave, const char* valor)
+{
+    ConfigTrafego* t = &p->trafego;
+    if (strcmp(chave, "intervalo_min") == 0) {
+        l->linha_intervalo_min = l->linha;
+        return ler_double(valor, &t->intervalo_min);
+    }
+    if (strcmp(chave, "intervalo_max") == 0) {
+        l->linha_intervalo_max = l->linha;
+        return ler_double(valor, &t->intervalo_max);
+    }
+    if (strcmp(chave, "fator_pico") == 0) {
+        l->linha_fator_pico = l->linha;
+        return ler_double(valor, &t->fator_pico);
+    }
+    if (strcmp(chave, "perfil") == 0) {
+        if (strcmp(valor, "uniforme") == 0)
+            t->perfil = PERFIL_UNIFORME;
+        else if (strcmp(valor, "subida") == 0)
+            t->perfil = PERFIL_SUBIDA;
+        else if (strcmp(valor, "descida") == 0)
+            t->perfil = PERFIL_DESCIDA;
+        else
+            return FALSE;
+        return TRUE;
+    }
+    return -1;
+}
+
+static int chave_politica(Predio* p, Leitor* l, const char* chave, const char* valor)
+{
+    ConfigPolitica* pol = &p->politica;
+    if (strcmp(chave, "estacionamento") == 0)
+        return ler_bool(valor, &pol->estacionamento);
+    if (strcmp(chave, "periodo_estacionamento") == 0) {
+        l->linha_periodo = l->linha;
+        return ler_double(valor, &pol->periodo_estacionamento);
+    }
+    if (strcmp(chave, "zonas") == 0)
+        return ler_int(valor, &pol->zonas_uniformes);
+    return -1;
+}
+
+static int ler_chave(Predio* p, Leitor* l, const char* chave, const char* valor)
+{
+    int ok;
+    switch (l->secao) {
+    case SECAO_PREDIO:   ok = chave_predio(p, l, chave, valor); break;
+    case SECAO_ELEVADOR: ok = chave_elevador(l, chave, valor); break;
+    case SECAO_ZONA:     ok = chave_zona(l, chave, valor); break;
+    case SECAO_TRAFEGO:  ok = chave_trafego(p, l, chave, valor); break;
+    case SECAO_POLITICA: ok = chave_politica(p, l, chave, valor); break;
+    default:
+        return erro(l->caminho, l->linha, "chave fora de secao: ", chave);
+    }
+    if (ok == -1)
+        return erro(l->caminho, l->linha, "chave desconhecida: ", chave);
+    if (!ok)
+        return erro(l->caminho, l->linha, "valor invalido para ", chave);
+    return TRUE;
+}
+
+
+/* === VALIDACAO === */
+static int validar(Predio* p, Leitor* l)
+{
+    const char* arq = l->caminho;
+
+    if (p->n_andares < 2)
+        return erro(arq, l->linha_andares, "o predio precisa de pelo menos 2 andares", "");
+    if (p->n_elevadores < 1)
+        return erro(arq, 0, "nenhuma secao [elevador] definida", "");
+
+    // Alturas: um valor unico vale para todos; senao, um por intervalo entre andares
+    if (l->n_alturas != 0 && l->n_alturas != 1 && l->n_alturas != p->n_andares - 1)
+        return erro(arq, l->linha_alturas, "'alturas' deve ter um valor ou um por intervalo entre andares (andares - 1)", "");
+    p->cota = malloc(p->n_andares * sizeof(double));
+    if (p->cota == NULL)
+        return erro(arq, 0, "sem memoria para a tabela de andares", "");
+    p->cota[0] = 0.0;
+    for (int a = 1; a < p->n_andares; a++) {
+        double altura = ALTURA_ANDAR_PADRAO;
+        if (l->n_alturas == 1)
+            altura = l->alturas[0];
+        else if (l->n_alturas > 1)
+            altura = l->alturas[a - 1];
+        if (altura <= 0)
+            return erro(arq, l->linha_alturas, "alturas devem ser positivas", "");
+        p->cota[a] = p->cota[a - 1] + altura;
+    }
+
+    for (int i = 0; i < p->n_elevadores; i++) {
+        ConfigElevador* e = &p->elevadores[i];
+        if (e->andar_max == -1)
+            e->andar_max = p->n_andares - 1;
+        if (e->velocidade <= 0)
+            return erro(arq, e->linha, "velocidade deve ser positiva", "");
+        if (e->tempo_porta < 0)
+            return erro(arq, e->linha, "tempo_porta nao pode ser negativo", "");
+        if (e->capacidade < 1)
+            return erro(arq, e->linha, "capacidade deve ser pelo menos 1", "");
+        if (e->andar_min < 0 || e->andar_max >= p->n_andares)
+            return erro(arq, e->linha, "andares atendidos fora do predio", "");
+    }
+
+    // O modulo de zonas tem tabela fixa: a primeira secao excedente e o erro
+    if (p->n_zonas > MAX_ZONAS) {
+        char limite[32];
+        snprintf(limite, sizeof(limite), " (maximo %d)", MAX_ZONAS);
+        return erro(arq, p->zonas[MAX_ZONAS].linha, "secoes [zona] demais", limite);
+    }
+
+    // Cada elevador pertence a no maximo uma zona e precisa atender todos os andares dela
+    int zona_do_elevador[p->n_elevadores];
+    for (int i = 0; i < p->n_elevadores; i++)
+        zona_do_elevador[i] = -1;
+    for (int z = 0; z < p->n_zonas; z++) {
+        ConfigZona* zona = &p->zonas[z];
+        if (zona->andar_min < 0 || zona->andar_max >= p->n_andares)
+            return erro(arq, zona->linha, "andares da zona fora do predio", "");
+        if (zona->andar_transferencia < 0 || zona->andar_transferencia >= p->n_andares)
+            return erro(arq, zona->linha, "andar de transferencia fora do predio", "");
+
+        for (int k = 0; k < zona->n_ids; k++) {
+            int id = p->ids_zonas[zona->inicio_ids + k];
+            if (id < 0 || id >= p->n_elevadores)
+                return erro(arq, zona->linha, "zona referencia elevador inexistente", "");
+            if (zona_do_elevador[id] != -1)
+                return erro(arq, zona->linha, "elevador ja pertence a outra zona", "");
+            zona_do_elevador[id] = z;
+
+            ConfigElevador* e = &p->elevadores[id];
+            int min = zona->andar_min < zona->andar_transferencia ? zona->andar_min : zona->andar_transferencia;
+            int max = zona->andar_max > zona->andar_transferencia ? zona->andar_max : zona->andar_transferencia;
+            if (e->andar_min > min || e->andar_max < max)
+                return erro(arq, e->linha, "elevador nao atende todos os andares da sua zona", "");
+        }
+    }
+    for (int i = 0; p->n_zonas > 0 && i < p->n_elevadores; i++) {
+        if (zona_do_elevador[i] == -1)
+            return erro(arq, p->elevadores[i].linha, "elevador nao pertence a nenhuma zona", "");
+    }
+
+    // Sem zonas explicitas, os elevadores precisam atender o predio inteiro
+    for (int i = 0; p->n_zonas == 0 && i < p->n_elevadores; i++) {
+        ConfigElevador* e = &p->elevadores[i];
+        if (e->andar_min != 0 || e->andar_max != p->n_andares - 1)
+            return erro(arq, e->linha, "elevador com andares restritos exige secoes [zona]", "");
+    }
+
+    // Intervalos invalidos apontam para a ultima das duas chaves definida
+    ConfigTrafego* t = &p->trafego;
+    int linha_intervalo = l->linha_intervalo_min > l->linha_intervalo_max ? l->linha_intervalo_min
+                                                                          : l->linha_intervalo_max;
+    if (t->intervalo_min < 0 || t->intervalo_max < t->intervalo_min || t->intervalo_max <= 0)
+        return erro(arq, linha_intervalo, "[trafego] requer 0 <= intervalo_min <= intervalo_max e intervalo_max > 0", "");
+    if (t->fator_pico < 1)
+        return erro(arq, l->linha_fator_pico, "[trafego] fator_pico deve ser pelo menos 1", "");
+    if (p->politica.periodo_estacionamento <= 0)
+        return erro(arq, l->linha_periodo, "[politica] periodo_estacionamento deve ser positivo", "");
+    return TRUE;
+}
+
+
+/* === INTERFACE PUBLICA === */
+int config_predio_padrao(Predio* p, int n_andares, int n_elevadores, int n_chamadas)
+{
+    predio_vazio(p);
+    p->n_andares = n_andares;
+    p->n_chamadas = n_chamadas;
+    p->n_elevadores = n_elevadores;
+    p->cota = malloc(n_andares * sizeof(double));
+    p->elevadores = malloc(n_elevadores * sizeof(ConfigElevador));
+    if (p->cota == NULL || p->elevadores == NULL) {
+        printf("Erro: sem memoria para o modelo do predio\n");
+        return FALSE;
+    }
+    for (int a = 0; a < n_andares; a++)
+        p->cota[a] = a * ALTURA_ANDAR_PADRAO;
+    for (int i = 0; i < n_elevadores; i++) {
+        elevador_padrao(&p->elevadores[i]);
+        p->elevadores[i].andar_max = n_andares - 1;
+    }
+    return TRUE;
+}
+
+int config_carregar(const char* caminho, Predio* p)
+{
+    FILE* f = fopen(caminho, "r");
+    if (f == NULL) {
+        printf("Erro: nao foi possivel abrir %s\n", caminho);
+        return FALSE;
+    }
+
+    predio_vazio(p);
+    Leitor l;
+    memset(&l, 0, sizeof(l));
+    l.caminho = caminho;
+
+    char buf[TAM_LINHA];
+    int ok = TRUE;
+    while (ok && fgets(buf, sizeof(buf), f) != NULL) {
+        l.linha++;
+
+        // Linha maior que o buffer: fgets a partiria em duas com numeracao errada
+        if (strchr(buf, '\n') == NULL) {
+            int c = fgetc(f);
+            if (c != EOF) {
+                char limite[32];
+                snprintf(limite, sizeof(limite), " (maximo %d caracteres)", TAM_LINHA - 2);
+                ok = erro(caminho, l.linha, "linha longa demais", limite);
+                break;
+            }
+        }
+
+        // Remove comentarios ('#' ou ';') e espacos
+        buf[strcspn(buf, "#;\r\n")] = '\0';
+        char* s = aparar(buf);
+        if (*s == '\0')
+            continue;
+
+        if (*s == '[') {
+            char* fim = strchr(s, ']');
+            if (fim == NULL || *aparar(fim + 1) != '\0') {
+                ok = erro(caminho, l.linha, "cabecalho de secao mal formado", "");
+                break;
+            }
+            *fim = '\0';
+            ok = fechar_secao(p, &l) && abrir_secao(&l, aparar(s + 1));
+            continue;
+        }
+
+        char* igual = strchr(s, '=');
+        if (igual == NULL) {
+            ok = erro(caminho, l.linha, "esperado 'chave = valor'", "");
+            break;
+        }
+        *igual = '\0';
+        ok = ler_chave(p, &l, aparar(s), aparar(igual + 1));
+    }
+    fclose(f);
+
+    if (ok)
+        ok = fechar_secao(p, &l) && validar(p, &l);
+
+    free(l.alturas);
+    free(l.ids);
+    if (!ok)
+        config_liberar(p);
+    return ok;
+}
+
+void config_liberar(Predio* p)
+{
+    free(p->cota);
+    free(p->elevadores);
+    free(p->zonas);
+    free(p->ids_zonas);
+    p->cota = NULL;
+    p->elevadores = NULL;
+    p->zonas = NULL;
+    p->ids_zonas = NULL;
+}
@@ -0,0 +1,76 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+/* === MODELO DO EDIFICIO === */
+#define ALTURA_ANDAR_PADRAO 3.0     // Metros entre andares
+#define VELOCIDADE_PADRAO 3.0       // Metros por segundo (1 andar/s)
+#define TEMPO_PORTA_PADRAO 0.0      // Segundos por parada
+#define CAPACIDADE_PADRAO 8         // Passageiros (chamadas) comprometidos por elevador
+
+// Perfis de trafego suportados
+#define PERFIL_UNIFORME 0   // Todos os andares geram chamadas no mesmo ritmo
+#define PERFIL_SUBIDA 1     // Pico de subida: terreo gera fator_pico vezes mais chamadas
+#define PERFIL_DESCIDA 2    // Pico de descida: maioria das chamadas vai para o terreo
+
+// Elevador (uma linha da tabela de elevadores)
+typedef struct
+{
+    double velocidade;  // m/s
+    double tempo_porta; // s por parada
+    int capacidade;
+    int andar_min;      // Faixa de andares atendidos
+    int andar_max;
+    int linha;          // Linha da definicao no arquivo (0 se padrao)
+} ConfigElevador;
+
+// Zona: faixa de andares, andar de transferencia e elevadores (em ids_zonas)
+typedef struct
+{
+    int andar_min;
+    int andar_max;
+    int andar_transferencia;
+    int inicio_ids;     // Primeiro indice em Predio.ids_zonas
+    int n_ids;
+    int linha;
+} ConfigZona;
+
+typedef struct
+{
+    double intervalo_min;   // Segundos entre chamadas de um mesmo andar
+    double intervalo_max;
+    int perfil;
+    double fator_pico;
+} ConfigTrafego;
+
+typedef struct
+{
+    int estacionamento;         // TRUE/FALSE
+    double periodo_estacionamento;
+    int zonas_uniformes;        // Usado quando nao ha secoes [zona]
+} ConfigPolitica;
+
+// Edificio completo, montado uma unica vez na inicializacao em tabelas contiguas
+typedef struct
+{
+    int n_andares;
+    double* cota;               // Altura (m) de cada andar em relacao ao terreo
+    int n_elevadores;
+    ConfigElevador* elevadores;
+    int n_zonas;
+    ConfigZona* zonas;
+    int* ids_zonas;             // Elevadores de todas as zonas, concatenados
+    int n_chamadas;
+    ConfigTrafego trafego;
+    ConfigPolitica politica;
+} Predio;
+
+// Monta o edificio padrao usado pelos argumentos posicionais da linha de comando
+int config_predio_padrao(Predio* p, int n_andares, int n_elevadores, int n_chamadas);
+
+// Carrega o edificio de um arquivo INI. Em caso de erro imprime
+// "<arquivo>:<linha>: <mensagem>" e retorna FALSE.
+int config_carregar(const char* caminho, Predio* p);
+
+void config_liberar(Predio* p);
+
+#endif
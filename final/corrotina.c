@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "corrotina.h"
+
+#define TRUE 1
+#define FALSE 0
+
+
+/* === VARIAVEIS GLOBAIS === */
+static __thread Corrotina* atual = NULL;
+
+
+/* === EXECUCAO === */
+// makecontext so repassa argumentos int: a corrotina que comeca e a corrente da thread
+static void trampolim(void)
+{
+    Corrotina* c = atual;
+    c->funcao(c->arg);
+    c->terminada = TRUE;
+    atual = c->anterior;
+    setcontext(&c->retorno);
+}
+
+int corrotina_criar(Corrotina* c, FuncaoCorrotina funcao, void* arg, size_t tam_pilha)
+{
+    c->pilha = malloc(tam_pilha);
+    if (c->pilha == NULL || getcontext(&c->contexto) != 0) {
+        printf("Erro: sem memoria para a pilha da corrotina\n");
+        free(c->pilha);
+        c->pilha = NULL;
+        return FALSE;
+    }
+    c->contexto.uc_stack.ss_sp = c->pilha;
+    c->contexto.uc_stack.ss_size = tam_pilha;
+    c->contexto.uc_link = NULL;
+    makecontext(&c->contexto, trampolim, 0);
+    c->anterior = NULL;
+    c->funcao = funcao;
+    c->arg = arg;
+    c->terminada = FALSE;
+    return TRUE;
+}
+
+void corrotina_destruir(Corrotina* c)
+{
+    free(c->pilha);
+    c->pilha = NULL;
+}
+
+void corrotina_retomar(Corrotina* c)
+{
+    if (c->terminada)
+        return;
+    c->anterior = atual;
+    atual = c;
+    swapcontext(&c->retorno, &c->contexto);
+}
+
+void corrotina_ceder(void)
+{
+    Corrotina* c = atual;
+    atual = c->anterior;
+    swapcontext(&c->contexto, &c->retorno);
+}
+
+Corrotina* corrotina_atual(void)
+{
+    return atual;
+}
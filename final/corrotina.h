@@ -0,0 +1,44 @@
+#ifndef CORROTINA_H
+#define CORROTINA_H
+
+#include <stddef.h>
+#include <ucontext.h>
+
+/* === CORROTINAS COM PILHA PROPRIA (ucontext) === */
+// Cada corrotina roda uma funcao sequencial na sua pilha e cede o processador
+// explicitamente; quem a retomou continua do ponto em que a retomou. Corrotinas
+// podem retomar outras (a cedida volta para quem a retomou por ultimo).
+// Nao ha escalonador: o chamador decide quem retomar (ex.: eventos do relogio virtual).
+// Cada thread tem a sua corrotina corrente: threads diferentes multiplexam conjuntos
+// diferentes de corrotinas, mas uma corrotina nunca deve mudar de thread.
+#define CORROTINA_PILHA_PADRAO (64 * 1024)
+
+typedef void (*FuncaoCorrotina)(void* arg);
+
+typedef struct Corrotina
+{
+    ucontext_t contexto;
+    ucontext_t retorno;             // Ponto de quem a retomou
+    struct Corrotina* anterior;     // Corrotina que a retomou (NULL: fluxo principal da thread)
+    void* pilha;
+    FuncaoCorrotina funcao;
+    void* arg;
+    int terminada;
+} Corrotina;
+
+// Prepara a corrotina sem executa-la. Retorna FALSE sem memoria.
+int corrotina_criar(Corrotina* c, FuncaoCorrotina funcao, void* arg, size_t tam_pilha);
+
+// Libera a pilha; a corrotina nao pode estar em execucao
+void corrotina_destruir(Corrotina* c);
+
+// Executa c ate ela ceder ou terminar
+void corrotina_retomar(Corrotina* c);
+
+// Suspende a corrotina corrente e volta para quem a retomou
+void corrotina_ceder(void);
+
+// Corrotina em execucao nesta thread, ou NULL no fluxo principal
+Corrotina* corrotina_atual(void);
+
+#endif
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "sinc.h"
+#include "demanda.h"
+
+
+/* === ESTRUTURAS DE DADOS === */
+// Contagem de chegadas de um andar em baldes de tempo (fila circular)
+typedef struct
+{
+    int contagem[JANELA_BALDES];
+    long balde[JANELA_BALDES];  // Indice absoluto do balde guardado em cada posicao
+} DemandaAndar;
+
+
+typedef struct
+{
+    DemandaAndar* andares_demanda;
+    int n_andares_demanda;
+    pthread_mutex_t mutex_demanda;
+    EstatisticaSinc est_mutex_demanda;
+} EstadoDemanda;
+
+
+/* === VARIAVEIS GLOBAIS === */
+// Instancia do processo, compartilhada pelas threads do simulador; demanda_isolar_thread
+// troca a da thread chamadora por uma privada
+static EstadoDemanda estado_processo = {.mutex_demanda = PTHREAD_MUTEX_INITIALIZER};
+static __thread EstadoDemanda estado_thread = {.mutex_demanda = PTHREAD_MUTEX_INITIALIZER};
+static __thread EstadoDemanda* estado = &estado_processo;
+
+
+/* === CICLO DE VIDA === */
+void demanda_isolar_thread(void)
+{
+    estado = &estado_thread;
+}
+
+void demanda_iniciar(int n_andares)
+{
+    if (estado == &estado_processo)
+        sinc_registrar(&estado->est_mutex_demanda, "mutex_demanda");
+    estado->andares_demanda = calloc(n_andares, sizeof(DemandaAndar));
+    if (estado->andares_demanda == NULL) {
+        printf("Erro: sem memoria para a tabela de demanda\n");
+        exit(1);
+    }
+    estado->n_andares_demanda = n_andares;
+}
+
+void demanda_finalizar(void)
+{
+    free(estado->andares_demanda);
+    estado->andares_demanda = NULL;
+    estado->n_andares_demanda = 0;
+}
+
+
+/* === REGISTRO E CONSULTA === */
+void demanda_registrar(int andar, double agora)
+{
+    long b = (long)(agora / DURACAO_BALDE);
+    int pos = b % JANELA_BALDES;
+
+    sinc_travar(&estado->mutex_demanda, &estado->est_mutex_demanda, -1);
+    DemandaAndar* d = &estado->andares_demanda[andar];
+    // Posicao ainda guarda um balde antigo: recomeca a contagem
+    if (d->balde[pos] != b) {
+        d->balde[pos] = b;
+        d->contagem[pos] = 0;
+    }
+    d->contagem[pos]++;
+    pthread_mutex_unlock(&estado->mutex_demanda);
+}
+
+// Chamar com mutex_demanda adquirido
+static double taxa_andar(const DemandaAndar* d, long b_atual)
+{
+    int total = 0;
+    for (int k = 0; k < JANELA_BALDES; k++) {
+        if (b_atual - d->balde[k] < JANELA_BALDES)
+            total += d->contagem[k];
+    }
+    return total / (JANELA_BALDES * DURACAO_BALDE);
+}
+
+double demanda_taxa(int andar, double agora)
+{
+    sinc_travar(&estado->mutex_demanda, &estado->est_mutex_demanda, -1);
+    double taxa = taxa_andar(&estado->andares_demanda[andar], (long)(agora / DURACAO_BALDE));
+    pthread_mutex_unlock(&estado->mutex_demanda);
+    return taxa;
+}
+
+int demanda_andares_mais_demandados(double agora, int* andares, int max)
+{
+    long b_atual = (long)(agora / DURACAO_BALDE);
+    double taxas[max > 0 ? max : 1];
+    int n = 0;
+
+    sinc_travar(&estado->mutex_demanda, &estado->est_mutex_demanda, -1);
+    for (int a = 0; a < estado->n_andares_demanda; a++) {
+        double taxa = taxa_andar(&estado->andares_demanda[a], b_atual);
+        if (taxa <= 0)
+            continue;
+
+        // Insercao ordenada (decrescente) entre os max melhores
+        int pos = n < max ? n++ : max;
+        while (pos > 0 && taxas[pos - 1] < taxa) {
+            if (pos < max) {
+                taxas[pos] = taxas[pos - 1];
+                andares[pos] = andares[pos - 1];
+            }
+            pos--;
+        }
+        if (pos < max) {
+            taxas[pos] = taxa;
+            andares[pos] = a;
+        }
+    }
+    pthread_mutex_unlock(&estado->mutex_demanda);
+    return n;
+}
+
+
+/* === CHECKPOINT === */
+void demanda_salvar(Checkpoint* c)
+{
+    sinc_travar(&estado->mutex_demanda, &estado->est_mutex_demanda, -1);
+    checkpoint_escrever(c, estado->andares_demanda, estado->n_andares_demanda * sizeof(DemandaAndar));
+    pthread_mutex_unlock(&estado->mutex_demanda);
+}
+
+void demanda_restaurar(Checkpoint* c)
+{
+    sinc_travar(&estado->mutex_demanda, &estado->est_mutex_demanda, -1);
+    checkpoint_ler(c, estado->andares_demanda, estado->n_andares_demanda * sizeof(DemandaAndar));
+    pthread_mutex_unlock(&estado->mutex_demanda);
+}
@@ -0,0 +1,32 @@
+#ifndef DEMANDA_H
+#define DEMANDA_H
+
+#include "checkpoint.h"
+
+/* === DEMANDA OBSERVADA POR ANDAR === */
+// Janela deslizante: JANELA_BALDES baldes de DURACAO_BALDE segundos cada
+#define JANELA_BALDES 12
+#define DURACAO_BALDE 5.0
+
+void demanda_iniciar(int n_andares);
+void demanda_finalizar(void);
+
+// A partir daqui, a thread chamadora usa um estado proprio do modulo (vazio ate o
+// demanda_iniciar). Sem isso, todas as threads compartilham o estado do processo.
+void demanda_isolar_thread(void);
+
+// Registra a chegada de um passageiro (chamada) no andar
+void demanda_registrar(int andar, double agora);
+
+// Taxa de chegadas no andar (chamadas/s) na janela mais recente
+double demanda_taxa(int andar, double agora);
+
+// Preenche andares[] com ate max andares de maior taxa (> 0), em ordem decrescente.
+// Retorna quantos andares foram preenchidos.
+int demanda_andares_mais_demandados(double agora, int* andares, int max);
+
+// Grava/le a tabela de demanda num checkpoint (mesmo numero de andares)
+void demanda_salvar(Checkpoint* c);
+void demanda_restaurar(Checkpoint* c);
+
+#endif
@@ -0,0 +1,997 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <math.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "deterministico.h"
+#include "relogio.h"
+#include "aleatorio.h"
+#include "trafego.h"
+#include "eta.h"
+#include "demanda.h"
+#include "zonas.h"
+#include "pool.h"
+#include "roda.h"
+#include "corrotina.h"
+#include "antecipacao.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define TAM_FILA_ELEVADOR 8     // Mesma capacidade de fila do motor com threads
+
+// Tipos de evento; em empate de instante, o menor tipo e processado primeiro
+#define EV_CHEGADA 0            // Elevador termina um trecho (viagem + portas)
+#define EV_CHAMADA 1            // Andar gera uma chamada
+#define EV_ESTACIONAMENTO 2     // Rodada da politica de estacionamento
+
+#define FAIXAS_ESPERA 4096       // Histograma das esperas: faixas de 0.25s ate 1024s,
+#define LARGURA_FAIXA_ESPERA 0.25 // mais uma faixa para o que passar disso
+
+#define RESOLUCAO_RODA (1.0 / 64)  // Tique da roda de eventos (s): viagens e intervalos de segundos
+
+// Registros do log de eventos (entram no digest)
+#define LOG_CHAMADA 1
+#define LOG_DESPACHO 2
+#define LOG_DESCARTE 3
+#define LOG_CHEGADA 4
+#define LOG_CONCLUSAO 5
+#define LOG_TRANSFERENCIA 6
+#define LOG_ESTACIONAMENTO 7
+
+
+/* === ESTRUTURAS DE DADOS === */
+typedef struct
+{
+    int origem;
+    int destino;            // Fim do trecho atual
+    int destino_final;
+    int reposicionamento;
+    double instante;        // Entrada do trecho atual no despacho
+} ChamadaDet;
+
+typedef struct
+{
+    int andar;
+    int em_andamento;
+    int indo_ao_destino;    // Trecho em curso: FALSE ate a origem, TRUE ate o destino
+    ChamadaDet* atual;
+    ChamadaDet* fila[TAM_FILA_ELEVADOR];
+    int fila_inicio;
+    int fila_contador;
+    int limite_fila;
+    int atendidas;
+} ElevadorDet;
+
+// Elevador como corrotina: o laco do carro fica sequencial e cede nas esperas de chegada
+typedef struct
+{
+    Corrotina corrotina;
+    int id;
+    int aguardando;         // Suspenso com a fila vazia, a espera de designacao
+} AgenteDet;
+
+typedef struct
+{
+    NoRoda no;              // Instante e encadeamento na roda (primeiro campo)
+    int tipo;
+    int alvo;               // Elevador ou andar
+    unsigned long long seq; // Ordem de insercao: desempate final
+} Evento;
+
+// Estado completo de uma execucao (nenhuma variavel global de simulacao)
+typedef struct
+{
+    const Predio* predio;
+    double agora;
+    Aleatorio* rng;             // Um fluxo por andar, como no motor com threads
+    ElevadorDet* elevadores;
+    AgenteDet* agentes;         // Um por elevador no modo de corrotinas; NULL na maquina de estados
+    Roda* eventos;              // Ordem (tempo, tipo, alvo, seq); nos no pool_eventos
+    unsigned long long seq;
+    uint64_t digest;
+    unsigned long long registros;
+    int imprimir_log;
+    int geradas;
+    int concluidas;
+    int descartadas;
+    double espera_total;        // Do despacho de cada trecho ao embarque
+    double espera_max;
+    long long embarques;
+    unsigned int faixas_espera[FAIXAS_ESPERA + 1];
+    uint64_t semente;
+    unsigned long long decisoes;    // Despacho por antecipacao: decisoes, rollouts e
+    unsigned long long rollouts;    // escolhas diferentes do menor ETA
+    unsigned long long desvios;
+    unsigned long long alocacoes;   // malloc/realloc feitos pelo motor (teste de escala)
+} SimulacaoDet;
+
+// Filtro do ETA nao recebe contexto: aponta para a execucao corrente da thread
+static __thread SimulacaoDet* sim_corrente = NULL;
+
+// Nos de evento e registros de chamada: pools dimensionados pelo edificio e
+// reaproveitados entre execucoes seguidas (reinicio em O(1), sem malloc por evento).
+// Uma roda e um par de pools por thread: varios predios simulam em paralelo (portfolio.c).
+static __thread Pool pool_eventos;
+static __thread Pool pool_chamadas;
+static __thread Roda roda_eventos;
+static __thread int roda_pronta = FALSE;
+
+static int usar_corrotinas = FALSE;
+static double horizonte_antecipacao = 0;    // 0: despacho guloso (menor ETA)
+
+// Pesos do despacho por custo, por thread: o otimizador simula pesos diferentes em paralelo
+static __thread PesosDespacho pesos = PESOS_DESPACHO_PADRAO;
+static __thread int pesos_ativos = FALSE;   // FALSE: os padrao, pelo caminho do menor ETA
+
+// Decisao do despacho por antecipacao em montagem (grande demais para a pilha)
+static __thread DecisaoAntecipacao decisao;
+
+
+/* === FILA DE EVENTOS (roda de tempo) === */
+static int antes(const NoRoda* na, const NoRoda* nb)
+{
+    const Evento* a = (const Evento*)na;
+    const Evento* b = (const Evento*)nb;
+    if (a->no.tempo != b->no.tempo)
+        return a->no.tempo < b->no.tempo;
+    if (a->tipo != b->tipo)
+        return a->tipo < b->tipo;
+    if (a->alvo != b->alvo)
+        return a->alvo < b->alvo;
+    return a->seq < b->seq;
+}
+
+// Cada andar, elevador e a politica de estacionamento tem no maximo um evento pendente:
+// o pool nunca se esgota num edificio valido
+static int agendar(SimulacaoDet* s, double tempo, int tipo, int alvo)
+{
+    Evento* ev = pool_alocar(&pool_eventos);
+    if (ev == NULL) {
+        printf("Erro: fila de eventos esgotada (%d eventos)\n", pool_eventos.capacidade);
+        return FALSE;
+    }
+    ev->tipo = tipo;
+    ev->alvo = alvo;
+    ev->seq = s->seq++;
+    return roda_agendar(s->eventos, &ev->no, tempo);
+}
+
+// Retira o proximo evento; o no volta ao pool e o evento e devolvido por valor
+static Evento retirar(SimulacaoDet* s)
+{
+    Evento* proximo = (Evento*)roda_retirar(s->eventos);
+    Evento ev = *proximo;
+    pool_devolver(&pool_eventos, proximo);
+    return ev;
+}
+
+
+/* === LOG DE EVENTOS E DIGEST === */
+// Registro binario de tamanho fixo; o instante entra em microssegundos inteiros
+static void registrar(SimulacaoDet* s, int tipo, int a, int b, int c)
+{
+    int64_t registro[5] = {(int64_t)(s->agora * 1e6 + 0.5), tipo, a, b, c};
+    const unsigned char* p = (const unsigned char*)registro;
+    for (size_t i = 0; i < sizeof(registro); i++) {
+        s->digest ^= p[i];
+        s->digest *= 1099511628211ULL;
+    }
+    s->registros++;
+}
+
+
+/* === DESPACHO === */
+static int aceita_chamada(int id)
+{
+    ElevadorDet* e = &sim_corrente->elevadores[id];
+    return e->fila_contador < e->limite_fila;
+}
+
+// Espera de um trecho, do despacho ao embarque (media e histograma)
+static void registrar_espera(SimulacaoDet* s, double espera)
+{
+    int faixa = (int)(espera / LARGURA_FAIXA_ESPERA);
+    s->faixas_espera[faixa < FAIXAS_ESPERA ? faixa : FAIXAS_ESPERA]++;
+    s->espera_total += espera;
+    if (espera > s->espera_max)
+        s->espera_max = espera;
+    s->embarques++;
+}
+
+// Percentil q das esperas pelo limite superior da faixa. Chamadas descartadas contam
+// como espera infinita: com descartes acima de 1-q, o percentil e INFINITY.
+static double percentil_espera(const SimulacaoDet* s, double q)
+{
+    long long total = s->embarques + s->descartadas;
+    long long posicao = (long long)ceil(q * total);
+    if (total == 0)
+        return 0;
+    long long acumulado = 0;
+    for (int f = 0; f < FAIXAS_ESPERA; f++) {
+        acumulado += s->faixas_espera[f];
+        if (acumulado >= posicao)
+            return (f + 1) * LARGURA_FAIXA_ESPERA < s->espera_max ? (f + 1) * LARGURA_FAIXA_ESPERA : s->espera_max;
+    }
+    return acumulado + s->faixas_espera[FAIXAS_ESPERA] >= posicao ? s->espera_max : INFINITY;
+}
+
+static void iniciar_proxima(SimulacaoDet* s, int id)
+{
+    ElevadorDet* e = &s->elevadores[id];
+    e->atual = e->fila[e->fila_inicio];
+    e->fila_inicio = (e->fila_inicio + 1) % TAM_FILA_ELEVADOR;
+    e->fila_contador--;
+    e->em_andamento = TRUE;
+    e->indo_ao_destino = FALSE;
+    agendar(s, s->agora + eta_tempo_viagem(id, e->andar, e->atual->origem), EV_CHEGADA, id);
+}
+
+static void designar(SimulacaoDet* s, int id, ChamadaDet* c)
+{
+    ElevadorDet* e = &s->elevadores[id];
+    e->fila[(e->fila_inicio + e->fila_contador) % TAM_FILA_ELEVADOR] = c;
+    e->fila_contador++;
+    eta_comprometer_parada(id, c->origem, s->agora);
+    if (!c->reposicionamento)
+        eta_comprometer_parada(id, c->destino, s->agora);
+    // Corrotina em execucao (transferencia para o proprio carro) pega a chamada ao voltar ao laco
+    if (s->agentes != NULL) {
+        if (s->agentes[id].aguardando)
+            corrotina_retomar(&s->agentes[id].corrotina);
+    } else if (!e->em_andamento) {
+        iniciar_proxima(s, id);
+    }
+}
+
+/* === DESPACHO POR ANTECIPACAO === */
+static int comparar_chegadas(const void* pa, const void* pb)
+{
+    const ChegadaPrevista* a = (const ChegadaPrevista*)pa;
+    const ChegadaPrevista* b = (const ChegadaPrevista*)pb;
+    if (a->instante != b->instante)
+        return a->instante < b->instante ? -1 : 1;
+    return a->origem - b->origem;
+}
+
+// Chamadas previstas no horizonte cujo trecho cai na zona, sorteadas pelo perfil de trafego
+// num fluxo proprio de cada decisao (nao consome os geradores dos andares)
+static void prever_chegadas(SimulacaoDet* s, int z, DecisaoAntecipacao* d)
+{
+    const Predio* p = s->predio;
+    const Zona* zona = zonas_obter(z);
+    Aleatorio rng;
+    aleatorio_semear(&rng, s->semente, (uint64_t)p->n_andares + s->decisoes);
+
+    double fim = s->agora + horizonte_antecipacao;
+    d->fim = fim;
+    d->n_chegadas = 0;
+    for (int a = zona->andar_min; a <= zona->andar_max + 1; a++) {
+        int andar = a <= zona->andar_max ? a : zona->andar_transferencia;
+        if (a > zona->andar_max && andar >= zona->andar_min && andar <= zona->andar_max)
+            break;
+        double t = s->agora + trafego_intervalo(&p->trafego, &rng, andar);
+        while (t <= fim && d->n_chegadas < ANTECIPACAO_MAX_CHEGADAS) {
+            Trecho tr;
+            int destino = trafego_destino(&p->trafego, &rng, andar, p->n_andares);
+            if (zonas_proximo_trecho(andar, destino, &tr) && tr.zona == z) {
+                ChegadaPrevista* ch = &d->chegadas[d->n_chegadas++];
+                ch->instante = t;
+                ch->origem = andar;
+                ch->destino = tr.destino;
+            }
+            t += trafego_intervalo(&p->trafego, &rng, andar);
+        }
+    }
+    qsort(d->chegadas, d->n_chegadas, sizeof(ChegadaPrevista), comparar_chegadas);
+}
+
+// Candidatos sao os aceitos de menor ETA; com mais de um, o rollout decide. Com um so,
+// ou com antecipacao sem ganho, o resultado coincide com eta_melhor_elevador_em.
+static int escolher_antecipando(SimulacaoDet* s, const ChamadaDet* c, int z, double* eta)
+{
+    const Zona* zona = zonas_obter(z);
+    DecisaoAntecipacao* d = &decisao;
+    d->n_carros = zona->n_elevadores;
+    eta_copiar_frota(zona->elevadores, zona->n_elevadores, s->agora, d->frota.t_livre, d->frota.andar_livre, d->modelos);
+    d->cotas = eta_cotas();
+    d->agora = s->agora;
+    d->origem = c->origem;
+    d->destino = c->destino;
+
+    // Insercao ordenada estavel: empate fica com o primeiro da zona, como no guloso
+    double etas[ANTECIPACAO_MAX_CANDIDATOS];
+    d->n_candidatos = 0;
+    for (int k = 0; k < zona->n_elevadores; k++) {
+        int id = zona->elevadores[k];
+        if (!aceita_chamada(id))
+            continue;
+        double t = d->frota.t_livre[k] + eta_tempo_viagem(id, d->frota.andar_livre[k], c->origem);
+        int pos = d->n_candidatos;
+        while (pos > 0 && t < etas[pos - 1])
+            pos--;
+        if (pos == ANTECIPACAO_MAX_CANDIDATOS)
+            continue;
+        int fim = d->n_candidatos < ANTECIPACAO_MAX_CANDIDATOS ? d->n_candidatos : ANTECIPACAO_MAX_CANDIDATOS - 1;
+        for (int j = fim; j > pos; j--) {
+            etas[j] = etas[j - 1];
+            d->candidatos[j] = d->candidatos[j - 1];
+        }
+        etas[pos] = t;
+        d->candidatos[pos] = k;
+        if (d->n_candidatos < ANTECIPACAO_MAX_CANDIDATOS)
+            d->n_candidatos++;
+    }
+    if (d->n_candidatos == 0)
+        return -1;
+
+    int escolhido = 0;
+    if (d->n_candidatos > 1) {
+        prever_chegadas(s, z, d);
+        escolhido = antecipacao_decidir(d);
+        s->rollouts += d->n_candidatos;
+        s->desvios += escolhido != 0;
+    }
+    s->decisoes++;
+    *eta = etas[escolhido];
+    return zona->elevadores[d->candidatos[escolhido]];
+}
+
+// Menor custo ponderado entre os aceitos da zona; no empate, o primeiro da zona
+static int escolher_ponderado(SimulacaoDet* s, const ChamadaDet* c, const Zona* zona, double* eta)
+{
+    int melhor = -1;
+    double menor = 0;
+    for (int k = 0; k < zona->n_elevadores; k++) {
+        int id = zona->elevadores[k];
+        if (!aceita_chamada(id))
+            continue;
+        const ElevadorDet* e = &s->elevadores[id];
+        double t = eta_estimar(id, c->origem, s->agora);
+
+        // Paradas pendentes: origem e destino de cada trecho na fila e o que falta do atual
+        int paradas = 2 * e->fila_contador;
+        int afastando = FALSE;
+        if (e->em_andamento && e->atual != NULL) {
+            int alvo = e->indo_ao_destino ? e->atual->destino : e->atual->origem;
+            paradas += e->indo_ao_destino ? 1 : 2;
+            afastando = alvo != e->andar && (alvo > e->andar) != (c->origem > e->andar);
+        }
+        double custo = pesos.eta * (t - s->agora) + pesos.distancia * abs(e->andar - c->origem)
+                       + pesos.carga * e->fila_contador / e->limite_fila + pesos.paradas * paradas
+                       + pesos.direcao * afastando;
+        if (melhor == -1 || custo < menor) {
+            melhor = id;
+            menor = custo;
+            *eta = t;
+        }
+    }
+    return melhor;
+}
+
+
+// Scheduler: mesmo criterio do motor com threads (menor ETA dentro da zona do trecho).
+// Chamada descartada devolve o registro ao pool.
+static void despachar(SimulacaoDet* s, ChamadaDet* c)
+{
+    Trecho t;
+    if (!zonas_proximo_trecho(c->origem, c->destino_final, &t)) {
+        registrar(s, LOG_DESCARTE, c->origem, c->destino_final, -1);
+        s->descartadas++;
+        pool_devolver(&pool_chamadas, c);
+        return;
+    }
+    c->destino = t.destino;
+    c->instante = s->agora;
+
+    const Zona* zona = zonas_obter(t.zona);
+    double eta;
+    int melhor_id;
+    if (horizonte_antecipacao > 0 && zona->n_elevadores <= ANTECIPACAO_MAX_CARROS)
+        melhor_id = escolher_antecipando(s, c, t.zona, &eta);
+    else if (pesos_ativos)
+        melhor_id = escolher_ponderado(s, c, zona, &eta);
+    else
+        melhor_id = eta_melhor_elevador_em(zona->elevadores, zona->n_elevadores, c->origem,
+                                           s->agora, aceita_chamada, &eta);
+    if (melhor_id == -1) {
+        registrar(s, LOG_DESCARTE, c->origem, c->destino_final, -1);
+        if (s->imprimir_log)
+            printf("[t=%9.3f] [Scheduler] Nenhum elevador disponivel para a chamada %d -> %d\n",
+                   s->agora, c->origem, c->destino_final);
+        s->descartadas++;
+        pool_devolver(&pool_chamadas, c);
+        return;
+    }
+
+    registrar(s, LOG_DESPACHO, c->origem, c->destino, melhor_id);
+    if (s->imprimir_log)
+        printf("[t=%9.3f] [Scheduler] Chamada %d -> %d para elevador %d (ETA %.1fs)\n",
+               s->agora, c->origem, c->destino, melhor_id, eta - s->agora);
+    designar(s, melhor_id, c);
+}
+
+
+/* === EVENTOS === */
+static void tratar_chamada(SimulacaoDet* s, int andar)
+{
+    const Predio* p = s->predio;
+    if (s->geradas >= p->n_chamadas)
+        return;
+
+    // Chamadas vivas estao nas filas ou em andamento: o pool cobre a frota cheia
+    ChamadaDet* c = pool_alocar(&pool_chamadas);
+    c->origem = andar;
+    c->destino_final = trafego_destino(&p->trafego, &s->rng[andar], andar, p->n_andares);
+    c->destino = c->destino_final;
+    c->reposicionamento = FALSE;
+    c->instante = s->agora;
+    s->geradas++;
+    demanda_registrar(andar, s->agora);
+
+    registrar(s, LOG_CHAMADA, c->origem, c->destino_final, s->geradas);
+    if (s->imprimir_log)
+        printf("[t=%9.3f] [Andar %d] Nova chamada: %d -> %d\n", s->agora, andar, c->origem, c->destino_final);
+    despachar(s, c);
+
+    agendar(s, s->agora + trafego_intervalo(&p->trafego, &s->rng[andar], andar), EV_CHAMADA, andar);
+}
+
+static void concluir(SimulacaoDet* s, int id)
+{
+    ElevadorDet* e = &s->elevadores[id];
+    e->em_andamento = FALSE;
+    if (e->fila_contador > 0)
+        iniciar_proxima(s, id);
+}
+
+static void tratar_chegada(SimulacaoDet* s, int id)
+{
+    ElevadorDet* e = &s->elevadores[id];
+    ChamadaDet* c = e->atual;
+    e->andar = e->indo_ao_destino ? c->destino : c->origem;
+    eta_registrar_parada(id, e->andar, s->agora);
+    registrar(s, LOG_CHEGADA, id, e->andar, e->indo_ao_destino);
+
+    if (!e->indo_ao_destino) {
+        if (c->reposicionamento) {
+            if (s->imprimir_log)
+                printf("[t=%9.3f] [Elevador %d] Estacionado no andar %d\n", s->agora, id, e->andar);
+            pool_devolver(&pool_chamadas, c);
+            concluir(s, id);
+            return;
+        }
+        registrar_espera(s, s->agora - c->instante);
+        e->indo_ao_destino = TRUE;
+        agendar(s, s->agora + eta_tempo_viagem(id, e->andar, c->destino), EV_CHEGADA, id);
+        return;
+    }
+
+    e->atendidas++;
+    if (c->destino != c->destino_final) {
+        // Passageiro segue em outra zona a partir do andar de transferencia (mesmo registro)
+        registrar(s, LOG_TRANSFERENCIA, id, c->destino, c->destino_final);
+        if (s->imprimir_log)
+            printf("[t=%9.3f] [Elevador %d] Passageiro transfere no andar %d (destino %d)\n",
+                   s->agora, id, c->destino, c->destino_final);
+        c->origem = c->destino;
+        c->destino = c->destino_final;
+        concluir(s, id);
+        despachar(s, c);
+        return;
+    }
+
+    s->concluidas++;
+    registrar(s, LOG_CONCLUSAO, id, c->destino, s->concluidas);
+    if (s->imprimir_log)
+        printf("[t=%9.3f] [Elevador %d] Chamada %d -> %d concluida\n", s->agora, id, c->origem, c->destino);
+    pool_devolver(&pool_chamadas, c);
+    concluir(s, id);
+}
+
+/* === ELEVADOR COMO CORROTINA === */
+// Mesmos passos de tratar_chegada/concluir, escritos como o laco do funcao_elevador do motor
+// com threads. Cada chamada ao relogio (agendar) acontece na mesma ordem da maquina de
+// estados, entao o digest nao muda: o proximo trecho parte antes de a transferencia ser
+// despachada, como em concluir.
+
+// Proxima chamada da fila ja em viagem ate a origem, ou NULL com a fila vazia
+static ChamadaDet* partir(SimulacaoDet* s, int id)
+{
+    ElevadorDet* e = &s->elevadores[id];
+    e->em_andamento = FALSE;
+    if (e->fila_contador == 0)
+        return NULL;
+    iniciar_proxima(s, id);
+    return e->atual;
+}
+
+// Suspende o carro ate o evento de chegada e registra a parada
+static void chegar(SimulacaoDet* s, int id, int andar)
+{
+    ElevadorDet* e = &s->elevadores[id];
+    corrotina_ceder();
+    e->andar = andar;
+    eta_registrar_parada(id, e->andar, s->agora);
+    registrar(s, LOG_CHEGADA, id, e->andar, e->indo_ao_destino);
+}
+
+static void agente_elevador(void* arg)
+{
+    AgenteDet* agente = (AgenteDet*)arg;
+    SimulacaoDet* s = sim_corrente;
+    int id = agente->id;
+    ElevadorDet* e = &s->elevadores[id];
+    ChamadaDet* c = NULL;
+
+    while (TRUE) {
+        // Ocioso: designar retoma o carro quando houver chamada na fila
+        while (c == NULL) {
+            c = partir(s, id);
+            if (c == NULL) {
+                agente->aguardando = TRUE;
+                corrotina_ceder();
+                agente->aguardando = FALSE;
+            }
+        }
+
+        chegar(s, id, c->origem);
+        if (c->reposicionamento) {
+            if (s->imprimir_log)
+                printf("[t=%9.3f] [Elevador %d] Estacionado no andar %d\n", s->agora, id, e->andar);
+            pool_devolver(&pool_chamadas, c);
+            c = partir(s, id);
+            continue;
+        }
+
+        registrar_espera(s, s->agora - c->instante);
+        e->indo_ao_destino = TRUE;
+        agendar(s, s->agora + eta_tempo_viagem(id, e->andar, c->destino), EV_CHEGADA, id);
+        chegar(s, id, c->destino);
+        e->atendidas++;
+
+        if (c->destino != c->destino_final) {
+            registrar(s, LOG_TRANSFERENCIA, id, c->destino, c->destino_final);
+            if (s->imprimir_log)
+                printf("[t=%9.3f] [Elevador %d] Passageiro transfere no andar %d (destino %d)\n",
+                       s->agora, id, c->destino, c->destino_final);
+            c->origem = c->destino;
+            c->destino = c->destino_final;
+            ChamadaDet* proxima = partir(s, id);
+            despachar(s, c);
+            c = proxima;
+            continue;
+        }
+
+        s->concluidas++;
+        registrar(s, LOG_CONCLUSAO, id, c->destino, s->concluidas);
+        if (s->imprimir_log)
+            printf("[t=%9.3f] [Elevador %d] Chamada %d -> %d concluida\n", s->agora, id, c->origem, c->destino);
+        pool_devolver(&pool_chamadas, c);
+        c = partir(s, id);
+    }
+}
+
+// Cria as corrotinas e as leva ate a primeira espera (fila vazia), sem tocar no relogio
+static int iniciar_agentes(SimulacaoDet* s)
+{
+    int n = s->predio->n_elevadores;
+    s->agentes = calloc(n, sizeof(AgenteDet));
+    if (s->agentes == NULL)
+        return FALSE;
+    s->alocacoes += 1 + n;
+    for (int i = 0; i < n; i++) {
+        s->agentes[i].id = i;
+        if (!corrotina_criar(&s->agentes[i].corrotina, agente_elevador, &s->agentes[i], CORROTINA_PILHA_PADRAO)) {
+            for (int k = 0; k < i; k++)
+                corrotina_destruir(&s->agentes[k].corrotina);
+            free(s->agentes);
+            s->agentes = NULL;
+            return FALSE;
+        }
+    }
+    for (int i = 0; i < n; i++)
+        corrotina_retomar(&s->agentes[i].corrotina);
+    return TRUE;
+}
+
+static void liberar_agentes(SimulacaoDet* s)
+{
+    for (int i = 0; s->agentes != NULL && i < s->predio->n_elevadores; i++)
+        corrotina_destruir(&s->agentes[i].corrotina);
+    free(s->agentes);
+    s->agentes = NULL;
+}
+
+
+// Mesma politica da thread de estacionamento, aplicada no instante do evento
+static void tratar_estacionamento(SimulacaoDet* s)
+{
+    int n = s->predio->n_elevadores;
+    int alvos[n];
+    int livres[n];
+
+    int n_livres = 0;
+    for (int i = 0; i < n; i++)
+        if (!s->elevadores[i].em_andamento && s->elevadores[i].fila_contador == 0)
+            livres[n_livres++] = i;
+
+    if (n_livres > 0) {
+        int n_alvos = demanda_andares_mais_demandados(s->agora, alvos, n_livres);
+
+        for (int a = 0; a < n_alvos; a++) {
+            for (int k = 0; k < n_livres; k++) {
+                if (livres[k] != -1 && s->elevadores[livres[k]].andar == alvos[a]) {
+                    livres[k] = -1;
+                    alvos[a] = -1;
+                    break;
+                }
+            }
+        }
+
+        for (int a = 0; a < n_alvos; a++) {
+            if (alvos[a] == -1)
+                continue;
+            int melhor_k = -1;
+            int menor_dist = 0;
+            for (int k = 0; k < n_livres; k++) {
+                if (livres[k] == -1 || !zonas_cobre(zonas_do_elevador(livres[k]), alvos[a]))
+                    continue;
+                int dist = abs(s->elevadores[livres[k]].andar - alvos[a]);
+                if (melhor_k == -1 || dist < menor_dist) {
+                    menor_dist = dist;
+                    melhor_k = k;
+                }
+            }
+            if (melhor_k == -1)
+                break;
+
+            int id = livres[melhor_k];
+            livres[melhor_k] = -1;
+            ChamadaDet* c = pool_alocar(&pool_chamadas);
+            c->origem = alvos[a];
+            c->destino = alvos[a];
+            c->destino_final = alvos[a];
+            c->reposicionamento = TRUE;
+            registrar(s, LOG_ESTACIONAMENTO, id, alvos[a], 0);
+            if (s->imprimir_log)
+                printf("[t=%9.3f] [Estacionamento] Elevador %d -> andar %d\n", s->agora, id, alvos[a]);
+            designar(s, id, c);
+        }
+    }
+
+    agendar(s, s->agora + s->predio->politica.periodo_estacionamento, EV_ESTACIONAMENTO, 0);
+}
+
+
+/* === EXECUCAO === */
+static int preparar(SimulacaoDet* s, const Predio* predio, uint64_t semente, int imprimir_log)
+{
+    memset(s, 0, sizeof(*s));
+    s->predio = predio;
+    s->semente = semente;
+    s->digest = 14695981039346656037ULL;
+    s->imprimir_log = imprimir_log;
+    s->rng = calloc(predio->n_andares, sizeof(Aleatorio));
+    s->elevadores = calloc(predio->n_elevadores, sizeof(ElevadorDet));
+    s->alocacoes = 2;
+
+    // Um evento pendente por andar e por elevador, mais a rodada de estacionamento.
+    // Chamadas vivas: fila cheia mais a chamada em andamento de cada elevador, mais a
+    // que esta sendo despachada.
+    int max_eventos = predio->n_andares + predio->n_elevadores + 1;
+    int max_chamadas = predio->n_elevadores * (TAM_FILA_ELEVADOR + 1) + 1;
+    if (!roda_pronta) {
+        roda_pronta = roda_iniciar(&roda_eventos, RESOLUCAO_RODA, antes, 16);
+        s->alocacoes++;
+    }
+    roda_reiniciar(&roda_eventos);
+    char* antes_eventos = pool_eventos.memoria;
+    char* antes_chamadas = pool_chamadas.memoria;
+    int pools_ok = pool_preparar(&pool_eventos, sizeof(Evento), max_eventos)
+                   && pool_preparar(&pool_chamadas, sizeof(ChamadaDet), max_chamadas);
+    s->alocacoes += (pool_eventos.memoria != antes_eventos) + (pool_chamadas.memoria != antes_chamadas);
+    s->eventos = &roda_eventos;
+
+    if (s->rng == NULL || s->elevadores == NULL || !roda_pronta || !pools_ok) {
+        printf("Erro: sem memoria para a simulacao deterministica\n");
+        free(s->rng);
+        free(s->elevadores);
+        s->rng = NULL;
+        s->elevadores = NULL;
+        return FALSE;
+    }
+    sim_corrente = s;
+
+    for (int i = 0; i < predio->n_elevadores; i++)
+        s->elevadores[i].limite_fila = predio->elevadores[i].capacidade < TAM_FILA_ELEVADOR
+                                           ? predio->elevadores[i].capacidade : TAM_FILA_ELEVADOR;
+
+    if (usar_corrotinas && !iniciar_agentes(s)) {
+        printf("Erro: sem memoria para as corrotinas dos elevadores\n");
+        free(s->rng);
+        free(s->elevadores);
+        s->rng = NULL;
+        s->elevadores = NULL;
+        sim_corrente = NULL;
+        return FALSE;
+    }
+
+    // Primeira chamada de cada andar em t=0, como no motor com threads
+    int ok = TRUE;
+    for (int a = 0; a < predio->n_andares; a++) {
+        aleatorio_semear(&s->rng[a], semente, a);
+        ok = ok && agendar(s, 0, EV_CHAMADA, a);
+    }
+    if (predio->politica.estacionamento)
+        ok = ok && agendar(s, predio->politica.periodo_estacionamento, EV_ESTACIONAMENTO, 0);
+    return ok;
+}
+
+// Processa eventos ate ser gerada a chamada de numero limite (INT_MAX: ate o fim da simulacao).
+// Retorna TRUE enquanto ainda houver trabalho.
+static int avancar(SimulacaoDet* s, int limite)
+{
+    int n_chamadas = s->predio->n_chamadas;
+    while (s->eventos->n > 0 && s->geradas < limite
+           && (s->geradas < n_chamadas || s->concluidas + s->descartadas < n_chamadas)) {
+        Evento ev = retirar(s);
+        s->agora = ev.no.tempo;
+        if (ev.tipo == EV_CHEGADA && s->agentes != NULL)
+            corrotina_retomar(&s->agentes[ev.alvo].corrotina);
+        else if (ev.tipo == EV_CHEGADA)
+            tratar_chegada(s, ev.alvo);
+        else if (ev.tipo == EV_CHAMADA)
+            tratar_chamada(s, ev.alvo);
+        else
+            tratar_estacionamento(s);
+    }
+    return s->eventos->n > 0 && (s->geradas < n_chamadas || s->concluidas + s->descartadas < n_chamadas);
+}
+
+// Roda e pools ficam para a proxima execucao (deterministico_finalizar os libera)
+static void liberar(SimulacaoDet* s)
+{
+    liberar_agentes(s);
+    free(s->rng);
+    free(s->elevadores);
+    sim_corrente = NULL;
+}
+
+void deterministico_definir_corrotinas(int ativo)
+{
+    usar_corrotinas = ativo;
+}
+
+void deterministico_definir_antecipacao(double horizonte)
+{
+    horizonte_antecipacao = horizonte;
+}
+
+void deterministico_definir_pesos(const PesosDespacho* p)
+{
+    PesosDespacho padrao = PESOS_DESPACHO_PADRAO;
+    pesos = *p;
+    pesos_ativos = memcmp(&pesos, &padrao, sizeof(pesos)) != 0;
+}
+
+void deterministico_finalizar(void)
+{
+    pool_finalizar(&pool_eventos);
+    pool_finalizar(&pool_chamadas);
+    if (roda_pronta)
+        roda_finalizar(&roda_eventos);
+    roda_pronta = FALSE;
+}
+
+static void imprimir_resumo(const SimulacaoDet* s, uint64_t semente, int por_elevador)
+{
+    printf("Semente: %llu\n", (unsigned long long)semente);
+    printf("Tempo simulado: %.3fs\n", s->agora);
+    printf("Chamadas: %d geradas, %d concluidas, %d descartadas\n", s->geradas, s->concluidas, s->descartadas);
+    double p95 = percentil_espera(s, 0.95);
+    printf("Espera media ate o embarque: %.2fs (%lld embarques)", s->embarques > 0 ? s->espera_total / s->embarques : 0.0,
+           s->embarques);
+    if (isinf(p95))
+        printf(", p95 indefinido (mais de 5%% de descartes)\n");
+    else
+        printf(", p95 %.2fs\n", p95);
+    if (horizonte_antecipacao > 0)
+        printf("Antecipacao (%.0fs): %llu decisoes, %llu rollouts, %llu diferentes do menor ETA\n",
+               horizonte_antecipacao, s->decisoes, s->rollouts, s->desvios);
+    for (int i = 0; i < s->predio->n_elevadores && por_elevador; i++)
+        printf("- Elevador %d: andar %d, trechos atendidos: %d\n", i, s->elevadores[i].andar, s->elevadores[i].atendidas);
+    printf("Digest do log de eventos: %016llx (%llu eventos)\n", (unsigned long long)s->digest, s->registros);
+}
+
+int deterministico_simular(const Predio* predio, uint64_t semente, ResultadoDet* r)
+{
+    SimulacaoDet s;
+    int ok = preparar(&s, predio, semente, FALSE);
+    if (s.elevadores == NULL)
+        return FALSE;
+    if (ok)
+        avancar(&s, INT_MAX);
+
+    r->digest = s.digest;
+    r->registros = s.registros;
+    r->geradas = s.geradas;
+    r->concluidas = s.concluidas;
+    r->descartadas = s.descartadas;
+    r->embarques = s.embarques;
+    r->tempo_simulado = s.agora;
+    r->espera_media = s.embarques > 0 ? s.espera_total / s.embarques : 0;
+    r->espera_p50 = percentil_espera(&s, 0.50);
+    r->espera_p95 = percentil_espera(&s, 0.95);
+    r->espera_p99 = percentil_espera(&s, 0.99);
+    r->espera_max = s.espera_max;
+    liberar(&s);
+    return ok;
+}
+
+int deterministico_simular_predio(const Predio* predio, uint64_t semente, ResultadoDet* r)
+{
+    ModeloViagem* modelos = malloc(predio->n_elevadores * sizeof(ModeloViagem));
+    if (modelos == NULL) {
+        printf("Erro: sem memoria para os modelos de viagem\n");
+        return FALSE;
+    }
+    for (int i = 0; i < predio->n_elevadores; i++) {
+        modelos[i].velocidade = predio->elevadores[i].velocidade;
+        modelos[i].tempo_porta = predio->elevadores[i].tempo_porta;
+    }
+    eta_iniciar(predio->n_elevadores, modelos, predio->cota);
+    free(modelos);
+    demanda_iniciar(predio->n_andares);
+    zonas_iniciar(predio->n_elevadores);
+    if (predio->n_zonas > 0) {
+        for (int z = 0; z < predio->n_zonas; z++) {
+            const ConfigZona* cz = &predio->zonas[z];
+            if (zonas_adicionar(cz->andar_min, cz->andar_max, cz->andar_transferencia,
+                                &predio->ids_zonas[cz->inicio_ids], cz->n_ids) < 0) {
+                printf("Erro: nao foi possivel registrar a zona %d\n", z);
+                eta_finalizar();
+                demanda_finalizar();
+                zonas_finalizar();
+                return FALSE;
+            }
+        }
+    } else {
+        zonas_configurar_uniforme(predio->n_andares, predio->n_elevadores, predio->politica.zonas_uniformes);
+    }
+
+    int ok = deterministico_simular(predio, semente, r);
+
+    eta_finalizar();
+    demanda_finalizar();
+    zonas_finalizar();
+    return ok;
+}
+
+int deterministico_executar(const Predio* predio, uint64_t semente, int imprimir_log, const char* esperado)
+{
+    SimulacaoDet s;
+    int ok = preparar(&s, predio, semente, imprimir_log);
+    if (s.elevadores == NULL)
+        return FALSE;
+
+    // Termina quando todo passageiro gerado foi entregue ou descartado
+    if (ok)
+        avancar(&s, INT_MAX);
+
+    printf("\n=== SIMULACAO DETERMINISTICA FINALIZADA ===\n");
+    imprimir_resumo(&s, semente, TRUE);
+
+    if (ok && esperado != NULL) {
+        uint64_t alvo = strtoull(esperado, NULL, 16);
+        if (alvo == s.digest) {
+            printf("Digest confere com o esperado.\n");
+        } else {
+            printf("Erro: digest difere do esperado (%s)\n", esperado);
+            ok = FALSE;
+        }
+    }
+
+    liberar(&s);
+    return ok;
+}
+
+
+/* === TESTE DE ESCALA === */
+// RSS atual em KB (/proc/self/statm: paginas residentes no segundo campo)
+static long rss_atual_kb(void)
+{
+    long total, residentes;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (f == NULL)
+        return 0;
+    int lidos = fscanf(f, "%ld %ld", &total, &residentes);
+    fclose(f);
+    return lidos == 2 ? residentes * (sysconf(_SC_PAGESIZE) / 1024) : 0;
+}
+
+static long rss_pico_kb(void)
+{
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+}
+
+// Bytes em uso no heap (malloc), inclusive alocacoes de outros modulos
+static size_t heap_em_uso(void)
+{
+    struct mallinfo2 m = mallinfo2();
+    return m.uordblks + m.hblkhd;
+}
+
+int deterministico_teste_escala(const Predio* predio, uint64_t semente)
+{
+    int n_chamadas = predio->n_chamadas;
+    int aquecimento = n_chamadas / ESCALA_ETAPAS;
+    if (aquecimento < 1) {
+        printf("Erro: teste de escala precisa de pelo menos %d chamadas\n", ESCALA_ETAPAS);
+        return FALSE;
+    }
+
+    printf("[Escala] %d andares, %d elevadores, %d chamadas\n", predio->n_andares, predio->n_elevadores, n_chamadas);
+    double inicio = relogio_agora();
+    SimulacaoDet s;
+    int ok = preparar(&s, predio, semente, FALSE);
+    if (s.elevadores == NULL)
+        return FALSE;
+
+    // A primeira etapa e o aquecimento: fila de eventos e caches chegam ao tamanho de regime
+    unsigned long long alocacoes_aquecido = 0;
+    size_t heap_aquecido = 0;
+    long rss_aquecido = 0;
+    int geradas_aquecido = 0;
+    double tempo_etapa = inicio;
+    for (int etapa = 1; ok && etapa <= ESCALA_ETAPAS; etapa++) {
+        // A ultima etapa tambem drena os passageiros em viagem
+        int limite = etapa == ESCALA_ETAPAS ? INT_MAX : (int)((long long)n_chamadas * etapa / ESCALA_ETAPAS);
+        int geradas_antes = s.geradas;
+        avancar(&s, limite);
+        double agora = relogio_agora();
+
+        double duracao = agora - tempo_etapa;
+        printf("[Escala] %3d%%  %10d chamadas  %9.0f chamadas/s  RSS %7.1f MB  heap %8zu KB  alocacoes %llu\n",
+               100 * etapa / ESCALA_ETAPAS, s.geradas, duracao > 0 ? (s.geradas - geradas_antes) / duracao : 0.0,
+               rss_atual_kb() / 1024.0, heap_em_uso() / 1024, s.alocacoes);
+        tempo_etapa = agora;
+
+        if (etapa == 1) {
+            alocacoes_aquecido = s.alocacoes;
+            heap_aquecido = heap_em_uso();
+            rss_aquecido = rss_atual_kb();
+            geradas_aquecido = s.geradas;
+        }
+    }
+
+    double total = relogio_agora() - inicio;
+    int regime = s.geradas - geradas_aquecido;
+    unsigned long long alocacoes_regime = s.alocacoes - alocacoes_aquecido;
+    long long crescimento_heap = (long long)heap_em_uso() - (long long)heap_aquecido;
+
+    printf("\n=== TESTE DE ESCALA FINALIZADO ===\n");
+    imprimir_resumo(&s, semente, FALSE);
+    printf("Tempo de execucao: %.2fs (%.0f chamadas/s, %.0f eventos/s)\n", total,
+           total > 0 ? s.geradas / total : 0.0, total > 0 ? s.registros / total : 0.0);
+    printf("Pico de RSS: %.1f MB\n", rss_pico_kb() / 1024.0);
+    printf("Apos o aquecimento (%d chamadas): %.4f alocacoes por chamada, heap %+lld bytes, RSS %+ld KB\n",
+           regime, regime > 0 ? (double)alocacoes_regime / regime : 0.0, crescimento_heap,
+           rss_atual_kb() - rss_aquecido);
+
+    // Regime sem alocacao: o heap nao pode crescer depois do aquecimento
+    if (ok && (alocacoes_regime > 0 || crescimento_heap > 0)) {
+        printf("Erro: memoria cresceu depois do aquecimento\n");
+        ok = FALSE;
+    } else if (ok) {
+        printf("Memoria estavel depois do aquecimento.\n");
+    }
+
+    liberar(&s);
+    return ok;
+}
@@ -0,0 +1,77 @@
+#ifndef DETERMINISTICO_H
+#define DETERMINISTICO_H
+
+#include <stdint.h>
+#include "config.h"
+
+/* === MOTOR DETERMINISTICO (eventos discretos, relogio virtual) === */
+// Executa o mesmo modelo do motor com threads (trafego, zonas, ETA, estacionamento)
+// numa unica thread, com relogio virtual e ordem fixa para eventos simultaneos.
+// Cada evento processado entra no digest (FNV-1a de 64 bits) do log de eventos:
+// mesma entrada e mesma semente produzem o mesmo digest.
+//
+// Requer eta_iniciar, demanda_iniciar e as zonas ja configuradas para o predio.
+// Se esperado != NULL, compara o digest com ele (hexadecimal).
+// Retorna TRUE se a simulacao terminou e o digest confere (quando pedido).
+int deterministico_executar(const Predio* predio, uint64_t semente, int imprimir_log, const char* esperado);
+
+typedef struct
+{
+    uint64_t digest;
+    unsigned long long registros;
+    int geradas;
+    int concluidas;
+    int descartadas;
+    long long embarques;    // Trechos embarcados (a espera media e sobre eles)
+    double tempo_simulado;
+    double espera_media;    // Do despacho de cada trecho ao embarque (s)
+    double espera_p50;      // Percentis: descartes contam como espera infinita
+    double espera_p95;
+    double espera_p99;
+    double espera_max;
+} ResultadoDet;
+
+// Mesma execucao, sem log nem relatorio. Varias threads podem simular ao mesmo tempo,
+// cada uma com eta, demanda e zonas isolados (eta_isolar_thread etc.) e configurados.
+int deterministico_simular(const Predio* predio, uint64_t semente, ResultadoDet* r);
+
+// Configura ETA, demanda e zonas da thread chamadora para o predio (como o main),
+// simula e os finaliza. Com *_isolar_thread, varias threads simulam ao mesmo tempo.
+int deterministico_simular_predio(const Predio* predio, uint64_t semente, ResultadoDet* r);
+
+// Libera a roda de eventos e os pools da thread chamadora (mantidos entre execucoes seguidas)
+void deterministico_finalizar(void);
+
+// Executa cada elevador como uma corrotina (laco sequencial suspenso nas chegadas do
+// relogio virtual) no lugar da maquina de estados. O digest e o mesmo nos dois modos.
+void deterministico_definir_corrotinas(int ativo);
+
+// Despacho por antecipacao (ver antecipacao.h) com horizonte em segundos; 0 volta ao
+// despacho pelo menor ETA. Os rollouts usam o pool de antecipacao_iniciar.
+void deterministico_definir_antecipacao(double horizonte);
+
+/* === TESTE DE ESCALA === */
+#define ESCALA_ETAPAS 10        // Relatorios parciais; a primeira etapa e o aquecimento
+
+// Executa o motor deterministico sem log, relatando vazao (chamadas/s), RSS e heap a cada etapa.
+// Retorna FALSE se o motor alocar ou o heap crescer depois do aquecimento.
+int deterministico_teste_escala(const Predio* predio, uint64_t semente);
+
+// Despacho por custo: entre os aceitos da zona, vence o menor
+//   eta * ETA (s) + distancia * andares ate a origem + carga * fracao da fila ocupada
+//   + paradas * paradas pendentes + direcao * (1 se o carro se afasta da origem).
+// Os pesos padrao sao o menor ETA (mesmo digest). Vale para a thread chamadora.
+typedef struct
+{
+    double eta;
+    double distancia;
+    double carga;
+    double paradas;
+    double direcao;
+} PesosDespacho;
+
+#define PESOS_DESPACHO_PADRAO {1, 0, 0, 0, 0}
+
+void deterministico_definir_pesos(const PesosDespacho* p);
+
+#endif
@@ -0,0 +1,351 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "dimensionamento.h"
+#include "config.h"
+#include "deterministico.h"
+#include "relogio.h"
+#include "eta.h"
+#include "demanda.h"
+#include "zonas.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define MIN_REPLICAS 3          // Antes disso o desvio padrao nao diz nada
+
+
+/* === ESTRUTURAS DE DADOS === */
+typedef struct
+{
+    const Predio* predio;
+    uint64_t semente;
+    int ok;
+    ResultadoDet resultado;
+} Replica;
+
+// Lote compartilhado: cada thread retira a proxima replica livre
+typedef struct
+{
+    Replica* replicas;
+    int n;
+    int proxima;
+} LoteReplicas;
+
+// Resultado da avaliacao de um tamanho de frota
+typedef struct
+{
+    int avaliado;
+    int atende;
+    int conclusivo;         // FALSE: parou em max_replicas sem confianca
+    int n_replicas;
+    double media;           // Media dos p95 das replicas
+    double meia_largura;    // Do intervalo de 95% de confianca
+} Avaliacao;
+
+
+/* === ESTATISTICA === */
+// t de Student bicaudal de 95% por graus de liberdade (1..30); acima disso, a normal
+static double quantil_t(int graus)
+{
+    static const double tabela[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    return graus <= 30 ? tabela[graus - 1] : 1.960;
+}
+
+
+/* === VARIANTES DO PREDIO === */
+// Copia o predio com outra frota. Tabelas de andares e trafego sao compartilhadas
+// (somente leitura); elevadores e zonas sao do predio novo (liberar_variante).
+static int montar_variante(const Predio* base, int unidades, double velocidade, int capacidade, Predio* v)
+{
+    *v = *base;
+    int n_zonas = base->n_zonas;
+    v->n_elevadores = n_zonas > 0 ? unidades * n_zonas : unidades;
+    v->elevadores = malloc(v->n_elevadores * sizeof(ConfigElevador));
+    v->zonas = n_zonas > 0 ? malloc(n_zonas * sizeof(ConfigZona)) : NULL;
+    v->ids_zonas = n_zonas > 0 ? malloc(v->n_elevadores * sizeof(int)) : NULL;
+    if (v->elevadores == NULL || (n_zonas > 0 && (v->zonas == NULL || v->ids_zonas == NULL))) {
+        printf("Erro: sem memoria para a variante do predio\n");
+        free(v->elevadores);
+        free(v->zonas);
+        free(v->ids_zonas);
+        return FALSE;
+    }
+
+    for (int i = 0; i < v->n_elevadores; i++) {
+        int modelo = i % base->n_elevadores;
+        if (n_zonas > 0) {
+            const ConfigZona* z = &base->zonas[i / unidades];
+            modelo = base->ids_zonas[z->inicio_ids + (i % unidades) % z->n_ids];
+        }
+        v->elevadores[i] = base->elevadores[modelo];
+        if (velocidade > 0)
+            v->elevadores[i].velocidade = velocidade;
+        if (capacidade > 0)
+            v->elevadores[i].capacidade = capacidade;
+    }
+    for (int z = 0; z < n_zonas; z++) {
+        v->zonas[z] = base->zonas[z];
+        v->zonas[z].inicio_ids = z * unidades;
+        v->zonas[z].n_ids = unidades;
+        for (int j = 0; j < unidades; j++)
+            v->ids_zonas[z * unidades + j] = z * unidades + j;
+    }
+    return TRUE;
+}
+
+static void liberar_variante(Predio* v)
+{
+    free(v->elevadores);
+    free(v->zonas);
+    free(v->ids_zonas);
+}
+
+
+/* === REPLICAS === */
+static void* funcao_replicas(void* arg)
+{
+    LoteReplicas* lote = (LoteReplicas*)arg;
+    eta_isolar_thread();
+    demanda_isolar_thread();
+    zonas_isolar_thread();
+
+    while (TRUE) {
+        int i = __atomic_fetch_add(&lote->proxima, 1, __ATOMIC_RELAXED);
+        if (i >= lote->n)
+            break;
+        Replica* r = &lote->replicas[i];
+        r->ok = deterministico_simular_predio(r->predio, r->semente, &r->resultado);
+    }
+
+    deterministico_finalizar();
+    return NULL;
+}
+
+// Executa as replicas do lote em n_threads threads. Retorna FALSE se alguma falhou.
+static int executar_lote(Replica* replicas, int n, int n_threads)
+{
+    LoteReplicas lote = {replicas, n, 0};
+    if (n_threads > n)
+        n_threads = n;
+    pthread_t threads[n_threads];
+    for (int i = 0; i < n_threads; i++) {
+        if (pthread_create(&threads[i], NULL, funcao_replicas, &lote) != 0) {
+            printf("Erro: nao foi possivel criar a thread %d do dimensionamento\n", i);
+            exit(1);
+        }
+    }
+    for (int i = 0; i < n_threads; i++)
+        pthread_join(threads[i], NULL);
+
+    int ok = TRUE;
+    for (int i = 0; i < n; i++)
+        ok = ok && replicas[i].ok;
+    return ok;
+}
+
+
+/* === AVALIACAO DE UMA FROTA === */
+// Replicas em lotes de uma por thread ate o intervalo de confianca decidir. Retorna
+// FALSE se a simulacao falhar.
+static int avaliar(const Predio* predio, const ParametrosDimensionamento* p, int n_threads, Avaliacao* a)
+{
+    Replica* replicas = malloc(p->max_replicas * sizeof(Replica));
+    if (replicas == NULL) {
+        printf("Erro: sem memoria para as replicas\n");
+        return FALSE;
+    }
+
+    memset(a, 0, sizeof(*a));
+    a->avaliado = TRUE;
+    int ok = TRUE;
+    double soma = 0, soma_quadrados = 0;
+    while (a->n_replicas < p->max_replicas) {
+        int inicio = a->n_replicas;
+        int n = p->max_replicas - inicio < n_threads ? p->max_replicas - inicio : n_threads;
+        for (int i = 0; i < n; i++) {
+            replicas[inicio + i].predio = predio;
+            replicas[inicio + i].semente = p->semente + inicio + i;
+            replicas[inicio + i].ok = FALSE;
+        }
+        if (!executar_lote(&replicas[inicio], n, n_threads)) {
+            ok = FALSE;
+            break;
+        }
+        a->n_replicas += n;
+
+        // Descartes demais (p95 infinito) reprovam a frota sem mais replicas
+        int infinito = FALSE;
+        for (int i = inicio; i < a->n_replicas; i++) {
+            double p95 = replicas[i].resultado.espera_p95;
+            infinito = infinito || isinf(p95);
+            soma += p95;
+            soma_quadrados += p95 * p95;
+        }
+        if (infinito) {
+            a->media = INFINITY;
+            a->conclusivo = TRUE;
+            break;
+        }
+
+        int k = a->n_replicas;
+        a->media = soma / k;
+        if (k < MIN_REPLICAS)
+            continue;
+        double variancia = (soma_quadrados - k * a->media * a->media) / (k - 1);
+        a->meia_largura = quantil_t(k - 1) * sqrt(variancia > 0 ? variancia : 0) / sqrt(k);
+        if (a->media + a->meia_largura < p->alvo_p95 || a->media - a->meia_largura > p->alvo_p95) {
+            a->conclusivo = TRUE;
+            break;
+        }
+    }
+    a->atende = a->media < p->alvo_p95;
+
+    free(replicas);
+    return ok;
+}
+
+static void imprimir_avaliacao(int n_elevadores, const char* descricao, const Avaliacao* a)
+{
+    printf("[Dimensionamento] %4d elevadores %s: ", n_elevadores, descricao);
+    if (isinf(a->media))
+        printf("p95 indefinido (descartes) em %d replicas -> nao atende\n", a->n_replicas);
+    else
+        printf("p95 medio %.2fs +- %.2fs em %d replicas -> %s%s\n", a->media, a->meia_largura, a->n_replicas,
+               a->atende ? "atende" : "nao atende", a->conclusivo ? "" : " (inconclusivo)");
+}
+
+
+/* === BUSCA === */
+// Menor numero de unidades (elevadores, ou elevadores por zona) que atende o alvo entre
+// minimo e maximo, ou -1. Retorna FALSE se uma simulacao falhar.
+static int buscar(const Predio* base, const ParametrosDimensionamento* p, int n_threads, double velocidade,
+                  int capacidade, const char* descricao, int minimo, int maximo, int* melhor, Avaliacao* resultado)
+{
+    Avaliacao* avaliacoes = calloc(maximo + 1, sizeof(Avaliacao));
+    if (avaliacoes == NULL) {
+        printf("Erro: sem memoria para a busca\n");
+        return FALSE;
+    }
+
+    // Busca binaria em [minimo, maximo], comecando pelo maximo: se ele nao atende,
+    // nenhum atende
+    int ok = TRUE;
+    int lo = minimo, hi = maximo;
+    int sonda = maximo;
+    *melhor = -1;
+    while (ok) {
+        Predio variante;
+        if (!montar_variante(base, sonda, velocidade, capacidade, &variante)) {
+            ok = FALSE;
+            break;
+        }
+        ok = avaliar(&variante, p, n_threads, &avaliacoes[sonda]);
+        if (ok)
+            imprimir_avaliacao(variante.n_elevadores, descricao, &avaliacoes[sonda]);
+        liberar_variante(&variante);
+        if (!ok)
+            break;
+
+        if (avaliacoes[sonda].atende) {
+            *melhor = sonda;
+            hi = sonda;
+        } else {
+            lo = sonda + 1;
+        }
+        if (lo >= hi || *melhor == -1)
+            break;
+        sonda = lo + (hi - lo) / 2;
+    }
+
+    if (*melhor != -1)
+        *resultado = avaliacoes[*melhor];
+    free(avaliacoes);
+    return ok;
+}
+
+int dimensionamento_executar(const char* caminho, const ParametrosDimensionamento* p)
+{
+    Predio base;
+    if (!config_carregar(caminho, &base))
+        return FALSE;
+    if (base.n_chamadas < 2 || base.politica.zonas_uniformes < 1) {
+        printf("Erro: %s precisa de pelo menos 2 chamadas e 1 zona\n", caminho);
+        config_liberar(&base);
+        return FALSE;
+    }
+
+    // Unidade da busca: elevadores, ou elevadores por zona com secoes [zona]
+    int por_zona = base.n_zonas > 0 ? base.n_zonas : 1;
+    int minimo = base.n_zonas > 0 ? 1 : base.politica.zonas_uniformes;
+    int maximo = (p->max_elevadores > 0 ? p->max_elevadores : 4 * base.n_elevadores) / por_zona;
+    if (maximo < minimo) {
+        printf("Erro: limite de %d elevadores abaixo do minimo de %d\n", maximo * por_zona, minimo * por_zona);
+        config_liberar(&base);
+        return FALSE;
+    }
+
+    int n_threads = p->n_nucleos > 0 ? p->n_nucleos : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_threads < 1)
+        n_threads = 1;
+    int n_velocidades = p->n_velocidades > 0 ? p->n_velocidades : 1;
+    int n_capacidades = p->n_capacidades > 0 ? p->n_capacidades : 1;
+    printf("[Dimensionamento] %s: p95 < %.2fs, de %d a %d elevadores, ate %d replicas em %d threads\n", caminho,
+           p->alvo_p95, minimo * por_zona, maximo * por_zona, p->max_replicas, n_threads);
+
+    // Uma busca por combinacao; a recomendada e a de menos elevadores
+    int ok = TRUE;
+    int melhor_total = -1;
+    char melhor_descricao[64] = "";
+    Avaliacao melhor_avaliacao;
+    double inicio = relogio_agora();
+    for (int iv = 0; iv < n_velocidades && ok; iv++) {
+        for (int ic = 0; ic < n_capacidades && ok; ic++) {
+            double velocidade = p->n_velocidades > 0 ? p->velocidades[iv] : 0;
+            int capacidade = p->n_capacidades > 0 ? p->capacidades[ic] : 0;
+            char descricao[64];
+            int tam = 0;
+            tam += velocidade > 0 ? snprintf(descricao, sizeof(descricao), "(%.2f m/s", velocidade)
+                                  : snprintf(descricao, sizeof(descricao), "(velocidade do arquivo");
+            if (capacidade > 0)
+                snprintf(descricao + tam, sizeof(descricao) - tam, ", capacidade %d)", capacidade);
+            else
+                snprintf(descricao + tam, sizeof(descricao) - tam, ", capacidade do arquivo)");
+
+            int unidades;
+            Avaliacao a;
+            ok = buscar(&base, p, n_threads, velocidade, capacidade, descricao, minimo, maximo, &unidades, &a);
+            if (!ok)
+                break;
+            if (unidades == -1) {
+                printf("[Dimensionamento] %s: nenhuma frota ate %d elevadores atende o alvo\n", descricao,
+                       maximo * por_zona);
+            } else if (melhor_total == -1 || unidades * por_zona < melhor_total) {
+                melhor_total = unidades * por_zona;
+                melhor_avaliacao = a;
+                snprintf(melhor_descricao, sizeof(melhor_descricao), "%s", descricao);
+            }
+        }
+    }
+    double parede = relogio_agora() - inicio;
+
+    printf("\n=== DIMENSIONAMENTO FINALIZADO ===\n");
+    if (ok && melhor_total != -1) {
+        printf("Frota minima: %d elevadores %s\n", melhor_total, melhor_descricao);
+        printf("p95 da espera: %.2fs +- %.2fs (alvo %.2fs, %d replicas%s)\n", melhor_avaliacao.media,
+               melhor_avaliacao.meia_largura, p->alvo_p95, melhor_avaliacao.n_replicas,
+               melhor_avaliacao.conclusivo ? "" : ", inconclusivo");
+    } else if (ok) {
+        printf("Nenhuma frota ate %d elevadores atende p95 < %.2fs\n", maximo * por_zona, p->alvo_p95);
+    }
+    printf("Tempo de parede: %.2fs\n", parede);
+
+    config_liberar(&base);
+    return ok && melhor_total != -1;
+}
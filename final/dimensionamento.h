@@ -0,0 +1,35 @@
+#ifndef DIMENSIONAMENTO_H
+#define DIMENSIONAMENTO_H
+
+#include <stdint.h>
+
+/* === DIMENSIONAMENTO DA FROTA (SLA de espera) === */
+// Procura o menor numero de elevadores cujo p95 da espera ate o embarque fica abaixo
+// do alvo. Cada tamanho de frota e avaliado por replicas do motor deterministico com
+// sementes semente, semente+1, ... (as mesmas para todos os tamanhos), em paralelo.
+// As replicas param quando o intervalo de 95% de confianca da media dos p95 fica
+// inteiro de um lado do alvo, ou em max_replicas (decide a media).
+//
+// Com zonas uniformes, a busca e no total de elevadores; com secoes [zona], no numero
+// de elevadores por zona. Os elevadores novos copiam os do arquivo, em ciclo. A busca
+// e binaria e supoe que mais elevadores nao pioram o p95.
+#define DIMENSIONAMENTO_MAX_OPCOES 8    // Velocidades e capacidades alternativas
+
+typedef struct
+{
+    double alvo_p95;            // s
+    int max_elevadores;         // Limite da busca (0: 4 vezes a frota do arquivo)
+    int max_replicas;
+    int n_nucleos;              // 0: todos os nucleos
+    uint64_t semente;
+    int n_velocidades;          // 0: as do arquivo
+    double velocidades[DIMENSIONAMENTO_MAX_OPCOES];
+    int n_capacidades;          // 0: as do arquivo
+    int capacidades[DIMENSIONAMENTO_MAX_OPCOES];
+} ParametrosDimensionamento;
+
+// Busca uma frota para cada combinacao de velocidade e capacidade e recomenda a menor
+// (no empate, a primeira combinacao). Retorna TRUE se alguma atende o alvo.
+int dimensionamento_executar(const char* caminho, const ParametrosDimensionamento* p);
+
+#endif
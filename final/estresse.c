@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "estresse.h"
+
+#define TRUE 1
+#define FALSE 0
+
+
+/* === VARIAVEIS GLOBAIS === */
+static unsigned* atendimentos = NULL;
+static unsigned* descartes = NULL;
+static int total = 0;
+static unsigned long long progresso = 0;
+static int vigia_ativo = FALSE;
+static void (*despejar_estado)(void) = NULL;
+static pthread_t thread_vigia;
+
+
+/* === VIGIA DE PROGRESSO === */
+// Usa sleep (tempo real): o relogio da simulacao roda sem esperas neste modo
+static void* funcao_vigia(void* arg)
+{
+    unsigned long long visto = __atomic_load_n(&progresso, __ATOMIC_RELAXED);
+    int parado = 0;
+    while (__atomic_load_n(&vigia_ativo, __ATOMIC_ACQUIRE)) {
+        sleep(1);
+        unsigned long long atual = __atomic_load_n(&progresso, __ATOMIC_RELAXED);
+        parado = atual == visto ? parado + 1 : 0;
+        visto = atual;
+        if (parado >= ESTRESSE_LIMITE_SEM_PROGRESSO && __atomic_load_n(&vigia_ativo, __ATOMIC_ACQUIRE)) {
+            fflush(stdout);
+            fprintf(stderr, "Erro: sem progresso ha %ds (wakeup perdido ou deadlock)\n", parado);
+            if (despejar_estado != NULL)
+                despejar_estado();
+            _exit(2);
+        }
+    }
+    return 0;
+}
+
+
+/* === CICLO DE VIDA === */
+int estresse_iniciar(int n_chamadas, void (*despejar)(void))
+{
+    atendimentos = calloc(n_chamadas, sizeof(unsigned));
+    descartes = calloc(n_chamadas, sizeof(unsigned));
+    if (atendimentos == NULL || descartes == NULL) {
+        printf("Erro: sem memoria para o modo de estresse\n");
+        return FALSE;
+    }
+    total = n_chamadas;
+    despejar_estado = despejar;
+    vigia_ativo = TRUE;
+    pthread_create(&thread_vigia, NULL, funcao_vigia, NULL);
+    return TRUE;
+}
+
+// Os contadores duram ate estresse_verificar, chamada depois do join de todas as threads
+void estresse_progresso(void)
+{
+    __atomic_fetch_add(&progresso, 1, __ATOMIC_RELAXED);
+}
+
+void estresse_atendida(int id)
+{
+    if (id >= 0 && id < total)
+        __atomic_fetch_add(&atendimentos[id], 1, __ATOMIC_RELAXED);
+    estresse_progresso();
+}
+
+void estresse_descartada(int id)
+{
+    if (id >= 0 && id < total)
+        __atomic_fetch_add(&descartes[id], 1, __ATOMIC_RELAXED);
+    estresse_progresso();
+}
+
+int estresse_verificar(int n_geradas)
+{
+    __atomic_store_n(&vigia_ativo, FALSE, __ATOMIC_RELEASE);
+    pthread_join(thread_vigia, NULL);
+
+    int atendidas = 0, descartadas = 0, perdidas = 0, duplicadas = 0;
+    for (int id = 0; id < total; id++) {
+        unsigned a = __atomic_load_n(&atendimentos[id], __ATOMIC_RELAXED);
+        unsigned d = __atomic_load_n(&descartes[id], __ATOMIC_RELAXED);
+        if (id >= n_geradas) {
+            // Chamada nunca gerada nao pode ter sido entregue
+            duplicadas += a + d > 0;
+            continue;
+        }
+        atendidas += a == 1 && d == 0;
+        descartadas += a == 0 && d == 1;
+        perdidas += a + d == 0;
+        duplicadas += a + d > 1;
+    }
+
+    printf("\n=== VERIFICACAO DE ESTRESSE ===\n");
+    printf("Chamadas geradas: %d de %d\n", n_geradas, total);
+    printf("- atendidas uma vez: %d\n", atendidas);
+    printf("- descartadas uma vez: %d\n", descartadas);
+    printf("- perdidas: %d\n", perdidas);
+    printf("- entregues mais de uma vez: %d\n", duplicadas);
+
+    int ok = n_geradas == total && perdidas == 0 && duplicadas == 0;
+    if (ok)
+        printf("Invariantes conferem.\n");
+    else
+        printf("Erro: invariantes violadas\n");
+
+    free(atendimentos);
+    free(descartes);
+    atendimentos = descartes = NULL;
+    return ok;
+}
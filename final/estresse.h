@@ -0,0 +1,22 @@
+#ifndef ESTRESSE_H
+#define ESTRESSE_H
+
+/* === MODO DE ESTRESSE (invariantes do motor com threads) === */
+// Conta quantas vezes cada chamada foi entregue ou descartada e vigia o progresso:
+// se nada acontece por ESTRESSE_LIMITE_SEM_PROGRESSO segundos (wakeup perdido,
+// deadlock), despeja o estado e encerra o processo com codigo 2.
+#define ESTRESSE_LIMITE_SEM_PROGRESSO 10
+
+// despejar imprime o estado da simulacao quando o vigia dispara
+int estresse_iniciar(int n_chamadas, void (*despejar)(void));
+
+// Registro (thread-safe, atomicos relaxados)
+void estresse_progresso(void);
+void estresse_atendida(int id);
+void estresse_descartada(int id);
+
+// Encerra o vigia e confere que cada uma das n_geradas chamadas foi atendida ou
+// descartada exatamente uma vez. Retorna TRUE se as invariantes valem.
+int estresse_verificar(int n_geradas);
+
+#endif
@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "sinc.h"
+#include "eta.h"
+
+
+/* === ESTRUTURAS DE DADOS === */
+// Cache de ETA de um elevador: onde e quando ele fica livre apos as paradas comprometidas
+typedef struct
+{
+    double t_livre;                    // Instante previsto para concluir todas as paradas
+    int andar_livre;                   // Andar da ultima parada comprometida
+    double previsto[ETA_MAX_PARADAS];  // Instantes previstos de cada parada pendente (fila circular)
+    int inicio;
+    int contador;
+    unsigned long geracao;             // Geracao da ultima parada comprometida
+} CacheEta;
+
+
+typedef struct
+{
+    CacheEta* cache;
+    int n_cache;
+    ModeloViagem* modelos_viagem;
+    const double* cotas_andares;
+    pthread_rwlock_t trava_eta;        // Leitura: consultas (varios despachantes); escrita: atualizacoes
+    EstatisticaSinc est_trava_eta;
+    unsigned long geracao;             // Paradas comprometidas na frota (atomico)
+} EstadoEta;
+
+
+/* === VARIAVEIS GLOBAIS === */
+// Instancia do processo, compartilhada pelas threads do simulador; eta_isolar_thread
+// troca a da thread chamadora por uma privada
+static EstadoEta estado_processo = {.trava_eta = PTHREAD_RWLOCK_INITIALIZER};
+static __thread EstadoEta estado_thread = {.trava_eta = PTHREAD_RWLOCK_INITIALIZER};
+static __thread EstadoEta* estado = &estado_processo;
+
+
+/* === MODELO DE TEMPO DE VIAGEM === */
+double eta_tempo_viagem(int id, int de, int para)
+{
+    const ModeloViagem* m = &estado->modelos_viagem[id];
+    return fabs(estado->cotas_andares[para] - estado->cotas_andares[de]) / m->velocidade + m->tempo_porta;
+}
+
+double eta_tempo_porta(int id)
+{
+    return estado->modelos_viagem[id].tempo_porta;
+}
+
+// Inicio efetivo do proximo trecho: o elevador so parte quando estiver livre
+static double inicio_trecho(const CacheEta* c, double agora)
+{
+    return c->t_livre > agora ? c->t_livre : agora;
+}
+
+
+/* === CICLO DE VIDA === */
+void eta_isolar_thread(void)
+{
+    estado = &estado_thread;
+}
+
+void eta_iniciar(int n_elevadores, const ModeloViagem* modelos, const double* cotas)
+{
+    // Instancias privadas nao entram no relatorio de disputa (somem com a thread)
+    if (estado == &estado_processo)
+        sinc_registrar(&estado->est_trava_eta, "trava_eta");
+    estado->cache = calloc(n_elevadores, sizeof(CacheEta));
+    estado->modelos_viagem = malloc(n_elevadores * sizeof(ModeloViagem));
+    if (estado->cache == NULL || estado->modelos_viagem == NULL) {
+        printf("Erro: sem memoria para o cache de ETA\n");
+        exit(1);
+    }
+    memcpy(estado->modelos_viagem, modelos, n_elevadores * sizeof(ModeloViagem));
+    estado->cotas_andares = cotas;
+    estado->n_cache = n_elevadores;
+}
+
+void eta_finalizar(void)
+{
+    free(estado->cache);
+    free(estado->modelos_viagem);
+    estado->cache = NULL;
+    estado->modelos_viagem = NULL;
+    estado->n_cache = 0;
+}
+
+
+/* === CONSULTAS === */
+double eta_estimar(int id, int andar, double agora)
+{
+    sinc_travar_leitura(&estado->trava_eta, &estado->est_trava_eta, -1);
+    const CacheEta* c = &estado->cache[id];
+    double eta = inicio_trecho(c, agora) + eta_tempo_viagem(id, c->andar_livre, andar);
+    pthread_rwlock_unlock(&estado->trava_eta);
+    return eta;
+}
+
+// Custo O(candidatos): cada elevador e avaliado com uma unica consulta ao cache,
+// sem re-simular as paradas que ele ja tem comprometidas
+int eta_melhor_elevador_em(const int* ids, int n, int andar, double agora, int (*aceita)(int id), double* eta)
+{
+    int melhor_id = -1;
+    double menor_eta = 0;
+
+    sinc_travar_leitura(&estado->trava_eta, &estado->est_trava_eta, -1);
+    for (int k = 0; k < n; k++) {
+        int i = ids != NULL ? ids[k] : k;
+        if (aceita != NULL && !aceita(i))
+            continue;
+
+        const CacheEta* c = &estado->cache[i];
+        double t = inicio_trecho(c, agora) + eta_tempo_viagem(i, c->andar_livre, andar);
+        if (melhor_id == -1 || t < menor_eta) {
+            menor_eta = t;
+            melhor_id = i;
+        }
+    }
+    pthread_rwlock_unlock(&estado->trava_eta);
+
+    if (eta != NULL)
+        *eta = menor_eta;
+    return melhor_id;
+}
+
+void eta_copiar_frota(const int* ids, int n, double agora, double* t_livre, int* andar_livre, ModeloViagem* modelos)
+{
+    sinc_travar_leitura(&estado->trava_eta, &estado->est_trava_eta, -1);
+    for (int k = 0; k < n; k++) {
+        const CacheEta* c = &estado->cache[ids[k]];
+        t_livre[k] = inicio_trecho(c, agora);
+        andar_livre[k] = c->andar_livre;
+        modelos[k] = estado->modelos_viagem[ids[k]];
+    }
+    pthread_rwlock_unlock(&estado->trava_eta);
+}
+
+const double* eta_cotas(void)
+{
+    return estado->cotas_andares;
+}
+
+unsigned long eta_geracao(void)
+{
+    return __atomic_load_n(&estado->geracao, __ATOMIC_RELAXED);
+}
+
+int eta_comprometido_desde(int id, unsigned long geracao)
+{
+    sinc_travar_leitura(&estado->trava_eta, &estado->est_trava_eta, -1);
+    int alterado = estado->cache[id].geracao > geracao;
+    pthread_rwlock_unlock(&estado->trava_eta);
+    return alterado;
+}
+
+int eta_melhor_elevador(int andar, double agora, int (*aceita)(int id), double* eta)
+{
+    return eta_melhor_elevador_em(NULL, estado->n_cache, andar, agora, aceita, eta);
+}
+
+
+/* === ATUALIZACOES INCREMENTAIS === */
+void eta_comprometer_parada(int id, int andar, double agora)
+{
+    sinc_travar_escrita(&estado->trava_eta, &estado->est_trava_eta, -1);
+    CacheEta* c = &estado->cache[id];
+    c->t_livre = inicio_trecho(c, agora) + eta_tempo_viagem(id, c->andar_livre, andar);
+    c->andar_livre = andar;
+    c->geracao = __atomic_add_fetch(&estado->geracao, 1, __ATOMIC_RELAXED);
+
+    // Guarda o instante previsto da parada para corrigir a deriva quando ela ocorrer
+    if (c->contador < ETA_MAX_PARADAS) {
+        c->previsto[(c->inicio + c->contador) % ETA_MAX_PARADAS] = c->t_livre;
+        c->contador++;
+    }
+    pthread_rwlock_unlock(&estado->trava_eta);
+}
+
+void eta_registrar_parada(int id, int andar, double agora)
+{
+    sinc_travar_escrita(&estado->trava_eta, &estado->est_trava_eta, -1);
+    CacheEta* c = &estado->cache[id];
+
+    if (c->contador > 0) {
+        // Desloca as paradas restantes pela diferenca entre o real e o previsto
+        double deriva = agora - c->previsto[c->inicio];
+        c->inicio = (c->inicio + 1) % ETA_MAX_PARADAS;
+        c->contador--;
+        for (int k = 0; k < c->contador; k++)
+            c->previsto[(c->inicio + k) % ETA_MAX_PARADAS] += deriva;
+        c->t_livre += deriva;
+    }
+
+    // Sem paradas pendentes, o cache volta a refletir exatamente o estado do elevador
+    if (c->contador == 0) {
+        c->t_livre = agora;
+        c->andar_livre = andar;
+    }
+    pthread_rwlock_unlock(&estado->trava_eta);
+}
@@ -0,0 +1,60 @@
+#ifndef ETA_H
+#define ETA_H
+
+/* === MOTOR DE ETA (TEMPO ESTIMADO DE CHEGADA) === */
+// Maximo de paradas comprometidas acompanhadas por elevador
+#define ETA_MAX_PARADAS 32
+
+// Modelo de tempo de viagem de um elevador
+typedef struct
+{
+    double velocidade;      // Metros por segundo
+    double tempo_porta;     // Segundos de abertura e fechamento de portas por parada
+} ModeloViagem;
+
+// Aloca o cache de ETA da frota (todos os elevadores livres no andar 0).
+// cotas[] (altura de cada andar, em metros) deve permanecer valida ate eta_finalizar.
+void eta_iniciar(int n_elevadores, const ModeloViagem* modelos, const double* cotas);
+void eta_finalizar(void);
+
+// A partir daqui, a thread chamadora usa um estado proprio do modulo (vazio ate o
+// eta_iniciar). Sem isso, todas as threads compartilham o estado do processo.
+void eta_isolar_thread(void);
+
+// Tempo de viagem do elevador entre dois andares, incluindo a parada no andar final
+double eta_tempo_viagem(int id, int de, int para);
+
+// Tempo de abertura e fechamento de portas do elevador em cada parada
+double eta_tempo_porta(int id);
+
+// Instante estimado em que o elevador chega ao andar, apos suas paradas comprometidas
+double eta_estimar(int id, int andar, double agora);
+
+// Elevador com menor ETA ate o andar, entre os aceitos pelo filtro (NULL aceita todos).
+// Retorna -1 se nenhum elevador for aceito.
+int eta_melhor_elevador(int andar, double agora, int (*aceita)(int id), double* eta);
+
+// Mesmo que eta_melhor_elevador, mas avaliando apenas os n elevadores listados em ids[]
+// (custo proporcional ao tamanho da zona, nao da frota)
+int eta_melhor_elevador_em(const int* ids, int n, int andar, double agora, int (*aceita)(int id), double* eta);
+
+// Copia o estado livre (instante, nunca antes de agora, e andar) e o modelo de viagem dos
+// n elevadores listados para vetores planos, numa unica aquisicao da trava
+void eta_copiar_frota(const int* ids, int n, double agora, double* t_livre, int* andar_livre, ModeloViagem* modelos);
+
+// Alturas dos andares passadas a eta_iniciar
+const double* eta_cotas(void);
+
+// Geracao das designacoes: cresce a cada parada comprometida na frota. Um despachante le a
+// geracao antes de avaliar a frota; se o elevador escolhido recebeu parada depois dela
+// (eta_comprometido_desde), a avaliacao ficou velha e deve ser refeita.
+unsigned long eta_geracao(void);
+int eta_comprometido_desde(int id, unsigned long geracao);
+
+// Compromete o elevador com uma parada (atualiza o cache de forma incremental)
+void eta_comprometer_parada(int id, int andar, double agora);
+
+// Registra que o elevador chegou a proxima parada comprometida
+void eta_registrar_parada(int id, int andar, double agora);
+
+#endif
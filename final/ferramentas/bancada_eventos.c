@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "../roda.h"
+
+/* === BANCADA: RODA DE TEMPO x HEAP BINARIO === */
+// Reproduz a mistura de eventos do motor deterministico: cada andar tem a proxima chamada
+// pendente, cada elevador a proxima chegada e ha uma rodada periodica de estacionamento.
+// Parte das chamadas redireciona um elevador (cancela a chegada e agenda outra).
+// As duas filas processam a mesma sequencia; a ordem de saida tem de coincidir.
+// Compilar: gcc -O2 -o bancada_eventos ferramentas/bancada_eventos.c roda.c
+
+#define TRUE 1
+#define FALSE 0
+
+#define EVENTOS_PADRAO 5000000
+#define FRACAO_REDIRECIONA 0.1
+#define PERIODO_ESTACIONAMENTO 2.0
+
+typedef struct
+{
+    NoRoda no;
+    int alvo;               // Andar, elevador (deslocado de n_andares) ou -1 (estacionamento)
+    unsigned long long seq;
+} EventoBancada;
+
+typedef struct
+{
+    uint64_t estado;
+} Gerador;
+
+static double uniforme(Gerador* g)
+{
+    g->estado ^= g->estado << 13;
+    g->estado ^= g->estado >> 7;
+    g->estado ^= g->estado << 17;
+    return (g->estado >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int antes(const NoRoda* na, const NoRoda* nb)
+{
+    const EventoBancada* a = (const EventoBancada*)na;
+    const EventoBancada* b = (const EventoBancada*)nb;
+    if (a->no.tempo != b->no.tempo)
+        return a->no.tempo < b->no.tempo;
+    return a->seq < b->seq;
+}
+
+static double agora_real(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+
+/* === FILA SOB TESTE === */
+typedef struct
+{
+    int usa_roda;
+    Roda roda;
+    HeapNos heap;
+} Fila;
+
+static void fila_agendar(Fila* f, EventoBancada* ev, double tempo)
+{
+    if (f->usa_roda) {
+        roda_agendar(&f->roda, &ev->no, tempo);
+    } else {
+        ev->no.tempo = tempo;
+        heap_inserir(&f->heap, &ev->no);
+    }
+}
+
+static void fila_cancelar(Fila* f, EventoBancada* ev)
+{
+    if (f->usa_roda)
+        roda_cancelar(&f->roda, &ev->no);
+    else if (ev->no.local == RODA_HEAP)
+        heap_remover(&f->heap, &ev->no);
+}
+
+static EventoBancada* fila_retirar(Fila* f)
+{
+    return (EventoBancada*)(f->usa_roda ? roda_retirar(&f->roda) : heap_retirar(&f->heap));
+}
+
+
+/* === CARGA === */
+// Tempo de viagem de um elevador: distancia sorteada a 2.5 m/s e 3.5 m por andar, mais portas
+static double viagem(Gerador* g, int n_andares)
+{
+    return (1 + (int)(uniforme(g) * (n_andares - 1))) * 3.5 / 2.5 + 3.0;
+}
+
+// Retorna o digest da ordem de saida; duracao recebe o tempo de execucao
+static uint64_t executar(int usa_roda, int n_andares, int n_elevadores, long n_eventos, double* duracao)
+{
+    int n = n_andares + n_elevadores + 1;
+    EventoBancada* eventos = calloc(n, sizeof(EventoBancada));
+    Fila f;
+    f.usa_roda = usa_roda;
+    if (usa_roda)
+        roda_iniciar(&f.roda, 1.0 / 64, antes, 16);
+    else
+        heap_iniciar(&f.heap, n, antes);
+
+    Gerador g = {88172645463325252ULL};
+    unsigned long long seq = 0;
+    for (int i = 0; i < n; i++) {
+        eventos[i].alvo = i < n_andares + n_elevadores ? i : -1;
+        eventos[i].no.local = RODA_FORA;
+    }
+    for (int a = 0; a < n_andares; a++) {
+        eventos[a].seq = seq++;
+        fila_agendar(&f, &eventos[a], uniforme(&g) * 3.0);
+    }
+    for (int e = 0; e < n_elevadores; e++) {
+        eventos[n_andares + e].seq = seq++;
+        fila_agendar(&f, &eventos[n_andares + e], viagem(&g, n_andares));
+    }
+    eventos[n - 1].seq = seq++;
+    fila_agendar(&f, &eventos[n - 1], PERIODO_ESTACIONAMENTO);
+
+    uint64_t digest = 14695981039346656037ULL;
+    double inicio = agora_real();
+    for (long k = 0; k < n_eventos; k++) {
+        EventoBancada* ev = fila_retirar(&f);
+        double t = ev->no.tempo;
+        digest = (digest ^ ev->seq) * 1099511628211ULL;
+
+        ev->seq = seq++;
+        if (ev->alvo == -1) {
+            fila_agendar(&f, ev, t + PERIODO_ESTACIONAMENTO);
+        } else if (ev->alvo < n_andares) {
+            // Chamada: proxima do andar e, as vezes, um elevador redirecionado
+            fila_agendar(&f, ev, t + 1.0 + 2.0 * uniforme(&g));
+            if (uniforme(&g) < FRACAO_REDIRECIONA) {
+                EventoBancada* e = &eventos[n_andares + (int)(uniforme(&g) * n_elevadores)];
+                fila_cancelar(&f, e);
+                e->seq = seq++;
+                fila_agendar(&f, e, t + viagem(&g, n_andares));
+            }
+        } else {
+            fila_agendar(&f, ev, t + viagem(&g, n_andares));
+        }
+    }
+    *duracao = agora_real() - inicio;
+
+    if (usa_roda)
+        roda_finalizar(&f.roda);
+    else
+        heap_finalizar(&f.heap);
+    free(eventos);
+    return digest;
+}
+
+
+/* === FUNCAO PRINCIPAL === */
+int main(int argc, char* argv[])
+{
+    long n_eventos = argc > 1 ? atol(argv[1]) : EVENTOS_PADRAO;
+    if (n_eventos <= 0) {
+        printf("Erro: chamada do programa deve estar no formato %s [n_eventos]\n", argv[0]);
+        return 1;
+    }
+
+    const int predios[][2] = {{10, 3}, {30, 6}, {120, 32}, {1000, 256}, {10000, 2048}};
+    int n_predios = sizeof(predios) / sizeof(predios[0]);
+    int ok = TRUE;
+
+    printf("%-8s %-10s %14s %14s %9s\n", "andares", "elevadores", "heap (ns/ev)", "roda (ns/ev)", "ganho");
+    for (int p = 0; p < n_predios; p++) {
+        double t_heap, t_roda;
+        uint64_t d_heap = executar(FALSE, predios[p][0], predios[p][1], n_eventos, &t_heap);
+        uint64_t d_roda = executar(TRUE, predios[p][0], predios[p][1], n_eventos, &t_roda);
+        printf("%-8d %-10d %14.1f %14.1f %8.2fx\n", predios[p][0], predios[p][1],
+               t_heap * 1e9 / n_eventos, t_roda * 1e9 / n_eventos, t_heap / t_roda);
+        if (d_heap != d_roda) {
+            printf("Erro: ordem de saida difere entre heap e roda\n");
+            ok = FALSE;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "../injecao.h"
+
+/* === GERADOR DE CARGA PARA O SOCKET DE SERVICO === */
+// Envia pedidos aleatorios mantendo uma janela de pedidos sem resposta e mede a taxa.
+// Compilar: gcc -O2 -o injetor ferramentas/injetor.c
+
+static double agora(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int escrever_tudo(int fd, const void* dados, size_t n)
+{
+    const char* p = dados;
+    while (n > 0) {
+        ssize_t k = write(fd, p, n);
+        if (k <= 0)
+            return 0;
+        p += k;
+        n -= k;
+    }
+    return 1;
+}
+
+static int ler_tudo(int fd, void* dados, size_t n)
+{
+    char* p = dados;
+    while (n > 0) {
+        ssize_t k = read(fd, p, n);
+        if (k <= 0)
+            return 0;
+        p += k;
+        n -= k;
+    }
+    return 1;
+}
+
+static int enviar_pedido(int fd, uint32_t id, int n_andares)
+{
+    int32_t origem = rand() % n_andares;
+    int32_t destino = (origem + 1 + rand() % (n_andares - 1)) % n_andares;
+    uint32_t tamanho = INJECAO_TAM_PEDIDO;
+    unsigned char quadro[4 + INJECAO_TAM_PEDIDO];
+    memcpy(quadro, &tamanho, 4);
+    memcpy(quadro + 4, &id, 4);
+    memcpy(quadro + 8, &origem, 4);
+    memcpy(quadro + 12, &destino, 4);
+    return escrever_tudo(fd, quadro, sizeof(quadro));
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4) {
+        printf("Erro: chamada do programa deve estar no formato %s <socket> <n_andares> <n_pedidos> [janela]\n", argv[0]);
+        return 1;
+    }
+    const char* caminho = argv[1];
+    int n_andares = atoi(argv[2]);
+    int n_pedidos = atoi(argv[3]);
+    int janela = argc > 4 ? atoi(argv[4]) : 16;
+    if (n_andares < 2 || n_pedidos < 1 || janela < 1) {
+        printf("Erro: parametros invalidos\n");
+        return 1;
+    }
+
+    struct sockaddr_un endereco = {.sun_family = AF_UNIX};
+    snprintf(endereco.sun_path, sizeof(endereco.sun_path), "%s", caminho);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&endereco, sizeof(endereco)) != 0) {
+        printf("Erro: nao foi possivel conectar em %s\n", caminho);
+        return 1;
+    }
+
+    srand(time(NULL));
+    double inicio = agora();
+    int enviados = 0, recebidos = 0, designados = 0, recusados = 0;
+    double soma_eta = 0;
+
+    while (enviados < n_pedidos && enviados < janela)
+        if (!enviar_pedido(fd, enviados++, n_andares))
+            break;
+
+    while (recebidos < enviados) {
+        unsigned char quadro[4 + INJECAO_TAM_RESPOSTA];
+        if (!ler_tudo(fd, quadro, sizeof(quadro))) {
+            printf("Erro: conexao encerrada pelo simulador\n");
+            break;
+        }
+        int32_t elevador;
+        float eta;
+        memcpy(&elevador, quadro + 8, 4);
+        memcpy(&eta, quadro + 12, 4);
+        recebidos++;
+        if (elevador >= 0) {
+            designados++;
+            soma_eta += eta;
+        } else {
+            recusados++;
+        }
+        if (enviados < n_pedidos && !enviar_pedido(fd, enviados++, n_andares))
+            break;
+    }
+
+    double duracao = agora() - inicio;
+    printf("%d respostas em %.2fs: %.0f pedidos/s\n", recebidos, duracao, recebidos / duracao);
+    printf("- designados: %d (ETA medio %.1fs)\n", designados, designados ? soma_eta / designados : 0);
+    printf("- recusados: %d\n", recusados);
+    close(fd);
+    return 0;
+}
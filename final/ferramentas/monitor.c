@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "../compartilhado.h"
+
+/* === LEITOR DO SEGMENTO COMPARTILHADO === */
+// Le o estado da frota publicado com --compartilhar, sem interferir na simulacao.
+// Compilar: gcc -O2 -o monitor ferramentas/monitor.c
+
+static int64_t agora_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        printf("Erro: chamada do programa deve estar no formato %s </nome> [leituras_por_s]\n", argv[0]);
+        return 1;
+    }
+    double frequencia = argc > 2 ? atof(argv[2]) : 10;
+    if (frequencia <= 0) {
+        printf("Erro: frequencia de leitura deve ser positiva\n");
+        return 1;
+    }
+
+    int fd = shm_open(argv[1], O_RDONLY, 0);
+    if (fd < 0) {
+        printf("Erro: segmento %s nao existe (simulador rodando com --compartilhar?)\n", argv[1]);
+        return 1;
+    }
+    SegmentoCompartilhado* cab = mmap(NULL, sizeof(SegmentoCompartilhado), PROT_READ, MAP_SHARED, fd, 0);
+    if (cab == MAP_FAILED || __atomic_load_n(&cab->magico, __ATOMIC_ACQUIRE) != COMPARTILHADO_MAGICO
+        || cab->versao != COMPARTILHADO_VERSAO) {
+        printf("Erro: %s nao e um segmento de estado compativel\n", argv[1]);
+        return 1;
+    }
+    int n = cab->n_elevadores;
+    size_t tamanho = sizeof(SegmentoCompartilhado) + n * sizeof(SlotElevador);
+    munmap(cab, sizeof(SegmentoCompartilhado));
+    const SegmentoCompartilhado* seg = mmap(NULL, tamanho, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) {
+        printf("Erro: nao foi possivel mapear %s\n", argv[1]);
+        return 1;
+    }
+
+    struct timespec intervalo = {(time_t)(1 / frequencia), (long)((1 / frequencia - (time_t)(1 / frequencia)) * 1e9)};
+    while (__atomic_load_n(&seg->ativo, __ATOMIC_ACQUIRE)) {
+        double relogio = (agora_ns() - seg->epoca_ns) / 1e9 / seg->escala;
+        printf("t=%7.2fs\n", relogio);
+        for (int i = 0; i < n; i++) {
+            EstadoElevador e;
+            compartilhado_ler(&seg->elevadores[i], &e);
+
+            // Posicao interpolada dentro do trecho em curso
+            double posicao = e.andar;
+            if (e.destino != e.andar && e.chegada_ms > e.partida_ms) {
+                double fracao = (relogio * 1000 - e.partida_ms) / (e.chegada_ms - e.partida_ms);
+                fracao = fracao < 0 ? 0 : fracao > 1 ? 1 : fracao;
+                posicao = e.andar + (e.destino - e.andar) * fracao;
+            }
+            printf("  elevador %2d  andar %5.2f  %s  carga %d  atendidas %3d  paradas:",
+                   i, posicao, e.direcao > 0 ? "sobe " : e.direcao < 0 ? "desce" : "     ", e.carga, e.atendidas);
+            for (int k = 0; k < e.n_paradas; k++)
+                printf(" %d", e.paradas[k]);
+            printf("\n");
+        }
+        nanosleep(&intervalo, NULL);
+    }
+    printf("Simulacao encerrada.\n");
+    return 0;
+}
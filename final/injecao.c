@@ -0,0 +1,473 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "injecao.h"
+#include "relogio.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define MAX_CONEXOES 64
+#define MAX_PENDENTES 64        // Pedidos no buffer/scheduler aguardando resposta
+#define TAM_ENTRADA 1024        // Pedidos lidos aguardando vaga no buffer
+#define TAM_LOTE 32
+#define TAM_LEITURA 4096
+#define TAM_QUADRO(corpo) (4 + (corpo))
+#define PERIODO_RELATORIO 5.0    // Segundos reais entre relatorios de vazao
+
+// Identificadores dos descritores no epoll (conexoes usam o indice do slot)
+#define ID_SERVIDOR MAX_CONEXOES
+#define ID_RESPOSTAS (MAX_CONEXOES + 1)
+
+
+/* === ESTRUTURAS DE DADOS === */
+typedef struct
+{
+    int fd;                 // -1 se o slot esta livre
+    unsigned geracao;       // Incrementada ao fechar: invalida respostas de conexoes antigas
+    unsigned eventos;       // Interesse registrado no epoll
+    unsigned char entrada[TAM_LEITURA];
+    int n_entrada;
+    unsigned char* saida;
+    int n_saida;
+    int cap_saida;
+} Conexao;
+
+// Origem de um pedido (conexao e geracao dela)
+typedef struct
+{
+    int conexao;
+    unsigned geracao;
+    ChamadaExterna chamada;
+} PedidoLido;
+
+typedef struct
+{
+    int conexao;
+    unsigned geracao;
+    uint32_t id;
+} Pendente;
+
+typedef struct
+{
+    int pedido;
+    int elevador;
+    float eta;
+} Resposta;
+
+
+/* === VARIAVEIS GLOBAIS === */
+static Conexao conexoes[MAX_CONEXOES];
+static int fd_servidor = -1, fd_epoll = -1, fd_respostas = -1;
+static char caminho_socket[sizeof(((struct sockaddr_un*)0)->sun_path)];
+static int andares = 0;
+static FuncaoInjetar injetar = NULL;
+static int injecao_ativa = FALSE;       // Lido sem trava pela thread de E/S (atomicos)
+static pthread_t thread_injecao;
+
+// Fila de entrada (somente a thread de E/S)
+static PedidoLido entrada[TAM_ENTRADA];
+static int entrada_inicio = 0, entrada_contador = 0;
+static int leitura_pausada = FALSE;
+
+// Pedidos inseridos no buffer (somente a thread de E/S)
+static Pendente pendentes[MAX_PENDENTES];
+static int livres[MAX_PENDENTES];
+static int n_livres = 0;
+
+// Respostas do scheduler: cabem todas, pois so ha MAX_PENDENTES pedidos em voo
+static Resposta respostas[MAX_PENDENTES];
+static int respostas_inicio = 0, respostas_contador = 0;
+static pthread_mutex_t mutex_respostas = PTHREAD_MUTEX_INITIALIZER;
+
+// Taxa sustentada (em tempo real, independente de --escala-tempo)
+static unsigned long long pedidos_respondidos = 0;
+static double inicio_pedidos = -1, ultima_resposta = 0;
+
+
+/* === CONEXOES === */
+static void atualizar_interesse(int slot)
+{
+    Conexao* c = &conexoes[slot];
+    unsigned eventos = (leitura_pausada ? 0 : EPOLLIN) | (c->n_saida > 0 ? EPOLLOUT : 0);
+    if (eventos == c->eventos)
+        return;
+    struct epoll_event ev = {.events = eventos, .data.u32 = slot};
+    epoll_ctl(fd_epoll, EPOLL_CTL_MOD, c->fd, &ev);
+    c->eventos = eventos;
+}
+
+static void fechar_conexao(int slot)
+{
+    Conexao* c = &conexoes[slot];
+    epoll_ctl(fd_epoll, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    free(c->saida);
+    c->fd = -1;
+    c->geracao++;
+    c->saida = NULL;
+    c->n_saida = c->cap_saida = 0;
+    c->n_entrada = 0;
+}
+
+static void aceitar_conexoes(void)
+{
+    while (TRUE) {
+        int fd = accept4(fd_servidor, NULL, NULL, SOCK_NONBLOCK);
+        if (fd < 0)
+            return;
+
+        int slot = 0;
+        while (slot < MAX_CONEXOES && conexoes[slot].fd != -1)
+            slot++;
+        if (slot == MAX_CONEXOES) {
+            close(fd);
+            continue;
+        }
+
+        Conexao* c = &conexoes[slot];
+        c->fd = fd;
+        c->n_entrada = 0;
+        c->eventos = leitura_pausada ? 0 : EPOLLIN;
+        struct epoll_event ev = {.events = c->eventos, .data.u32 = slot};
+        epoll_ctl(fd_epoll, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+// Escreve o que for possivel sem bloquear; o restante espera EPOLLOUT
+static void descarregar(int slot)
+{
+    Conexao* c = &conexoes[slot];
+    int enviados = 0;
+    while (enviados < c->n_saida) {
+        // MSG_NOSIGNAL: cliente que fechou a conexao da EPIPE aqui, sem SIGPIPE no processo
+        ssize_t n = send(c->fd, c->saida + enviados, c->n_saida - enviados, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            fechar_conexao(slot);
+            return;
+        }
+        enviados += n;
+    }
+    memmove(c->saida, c->saida + enviados, c->n_saida - enviados);
+    c->n_saida -= enviados;
+    atualizar_interesse(slot);
+}
+
+static void enviar_resposta(int slot, uint32_t id, int elevador, float eta)
+{
+    Conexao* c = &conexoes[slot];
+    if (c->n_saida + TAM_QUADRO(INJECAO_TAM_RESPOSTA) > c->cap_saida) {
+        int cap = c->cap_saida == 0 ? 256 : 2 * c->cap_saida;
+        unsigned char* saida = realloc(c->saida, cap);
+        if (saida == NULL) {
+            fechar_conexao(slot);
+            return;
+        }
+        c->saida = saida;
+        c->cap_saida = cap;
+    }
+
+    uint32_t tamanho = INJECAO_TAM_RESPOSTA;
+    int32_t elev = elevador;
+    unsigned char* p = c->saida + c->n_saida;
+    memcpy(p, &tamanho, 4);
+    memcpy(p + 4, &id, 4);
+    memcpy(p + 8, &elev, 4);
+    memcpy(p + 12, &eta, 4);
+    c->n_saida += TAM_QUADRO(INJECAO_TAM_RESPOSTA);
+    pedidos_respondidos++;
+    ultima_resposta = relogio_real();
+}
+
+
+/* === LEITURA DOS PEDIDOS === */
+static void pausar_leitura(int pausar)
+{
+    if (leitura_pausada == pausar)
+        return;
+    leitura_pausada = pausar;
+    for (int i = 0; i < MAX_CONEXOES; i++)
+        if (conexoes[i].fd != -1)
+            atualizar_interesse(i);
+}
+
+// Extrai os quadros completos da conexao enquanto houver espaco na fila de entrada
+static void interpretar_pedidos(int slot)
+{
+    Conexao* c = &conexoes[slot];
+    int lidos = 0;
+    while (c->n_entrada - lidos >= TAM_QUADRO(INJECAO_TAM_PEDIDO) && entrada_contador < TAM_ENTRADA) {
+        unsigned char* p = c->entrada + lidos;
+        uint32_t tamanho, id;
+        int32_t origem, destino;
+        memcpy(&tamanho, p, 4);
+        if (tamanho != INJECAO_TAM_PEDIDO) {
+            printf("[Servico] Quadro invalido (%u bytes), conexao encerrada\n", tamanho);
+            fechar_conexao(slot);
+            return;
+        }
+        memcpy(&id, p + 4, 4);
+        memcpy(&origem, p + 8, 4);
+        memcpy(&destino, p + 12, 4);
+        lidos += TAM_QUADRO(INJECAO_TAM_PEDIDO);
+
+        if (inicio_pedidos < 0)
+            inicio_pedidos = relogio_real();
+
+        if (origem < 0 || origem >= andares || destino < 0 || destino >= andares || origem == destino) {
+            enviar_resposta(slot, id, INJECAO_PEDIDO_INVALIDO, 0);
+            continue;
+        }
+        PedidoLido* pl = &entrada[(entrada_inicio + entrada_contador) % TAM_ENTRADA];
+        pl->conexao = slot;
+        pl->geracao = c->geracao;
+        pl->chamada.id = id;
+        pl->chamada.origem = origem;
+        pl->chamada.destino = destino;
+        entrada_contador++;
+    }
+    memmove(c->entrada, c->entrada + lidos, c->n_entrada - lidos);
+    c->n_entrada -= lidos;
+    if (c->n_saida > 0)
+        descarregar(slot);
+}
+
+static void ler_conexao(int slot)
+{
+    Conexao* c = &conexoes[slot];
+    while (c->n_entrada < TAM_LEITURA) {
+        ssize_t n = read(c->fd, c->entrada + c->n_entrada, TAM_LEITURA - c->n_entrada);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            fechar_conexao(slot);
+            return;
+        }
+        if (n < 0)
+            break;
+        c->n_entrada += n;
+        interpretar_pedidos(slot);
+        if (c->fd == -1 || entrada_contador == TAM_ENTRADA)
+            break;
+    }
+    if (entrada_contador == TAM_ENTRADA)
+        pausar_leitura(TRUE);
+}
+
+
+/* === ENVIO AO SCHEDULER === */
+// Envia lotes da fila de entrada enquanto o buffer aceitar; pedidos de conexoes
+// ja fechadas sao descartados
+static void enviar_lotes(void)
+{
+    ChamadaExterna lote[TAM_LOTE];
+    while (entrada_contador > 0 && n_livres > 0) {
+        int n = 0;
+        while (n < TAM_LOTE && n < entrada_contador && n < n_livres) {
+            PedidoLido* pl = &entrada[(entrada_inicio + n) % TAM_ENTRADA];
+            if (conexoes[pl->conexao].geracao != pl->geracao)
+                break;
+            int pedido = livres[n_livres - 1 - n];
+            pendentes[pedido].conexao = pl->conexao;
+            pendentes[pedido].geracao = pl->geracao;
+            pendentes[pedido].id = pl->chamada.id;
+            lote[n] = pl->chamada;
+            lote[n].pedido = pedido;
+            n++;
+        }
+        if (n == 0) {
+            // Pedido de conexao fechada no inicio da fila
+            entrada_inicio = (entrada_inicio + 1) % TAM_ENTRADA;
+            entrada_contador--;
+            continue;
+        }
+
+        int aceitas = injetar(lote, n);
+        n_livres -= aceitas;
+        entrada_inicio = (entrada_inicio + aceitas) % TAM_ENTRADA;
+        entrada_contador -= aceitas;
+        if (aceitas < n)
+            break;
+    }
+    if (leitura_pausada && entrada_contador <= TAM_ENTRADA / 2)
+        pausar_leitura(FALSE);
+}
+
+// Encaminha as respostas do scheduler as conexoes de origem
+static void processar_respostas(void)
+{
+    uint64_t sinal;
+    if (read(fd_respostas, &sinal, sizeof(sinal)) < 0 && errno != EAGAIN)
+        return;
+
+    pthread_mutex_lock(&mutex_respostas);
+    Resposta lote[MAX_PENDENTES];
+    int n = respostas_contador;
+    for (int i = 0; i < n; i++)
+        lote[i] = respostas[(respostas_inicio + i) % MAX_PENDENTES];
+    respostas_inicio = (respostas_inicio + n) % MAX_PENDENTES;
+    respostas_contador = 0;
+    pthread_mutex_unlock(&mutex_respostas);
+
+    for (int i = 0; i < n; i++) {
+        Pendente* p = &pendentes[lote[i].pedido];
+        livres[n_livres++] = lote[i].pedido;
+        if (conexoes[p->conexao].fd != -1 && conexoes[p->conexao].geracao == p->geracao)
+            enviar_resposta(p->conexao, p->id, lote[i].elevador, lote[i].eta);
+    }
+    for (int i = 0; i < MAX_CONEXOES; i++)
+        if (conexoes[i].fd != -1 && conexoes[i].n_saida > 0)
+            descarregar(i);
+}
+
+void injecao_responder(int pedido, int elevador, double eta)
+{
+    pthread_mutex_lock(&mutex_respostas);
+    Resposta* r = &respostas[(respostas_inicio + respostas_contador) % MAX_PENDENTES];
+    r->pedido = pedido;
+    r->elevador = elevador;
+    r->eta = (float)eta;
+    respostas_contador++;
+    pthread_mutex_unlock(&mutex_respostas);
+
+    uint64_t um = 1;
+    if (write(fd_respostas, &um, sizeof(um)) < 0)
+        perror("[Servico] eventfd");
+}
+
+
+/* === LACO DE E/S === */
+static void* funcao_injecao(void* arg)
+{
+    struct epoll_event eventos[MAX_CONEXOES + 2];
+    double proximo_relatorio = relogio_real() + PERIODO_RELATORIO;
+    unsigned long long respondidos_relatorio = 0;
+
+    while (__atomic_load_n(&injecao_ativa, __ATOMIC_ACQUIRE)) {
+        // Com pedidos aguardando vaga no buffer, tenta de novo em 1 ms
+        int espera = entrada_contador > 0 ? 1 : 500;
+        int n = epoll_wait(fd_epoll, eventos, MAX_CONEXOES + 2, espera);
+
+        for (int i = 0; i < n; i++) {
+            unsigned id = eventos[i].data.u32;
+            if (id == ID_SERVIDOR) {
+                aceitar_conexoes();
+            } else if (id == ID_RESPOSTAS) {
+                processar_respostas();
+            } else if (conexoes[id].fd != -1) {
+                if (eventos[i].events & (EPOLLERR | EPOLLHUP)) {
+                    fechar_conexao(id);
+                    continue;
+                }
+                if (eventos[i].events & EPOLLOUT)
+                    descarregar(id);
+                if (conexoes[id].fd != -1 && (eventos[i].events & EPOLLIN))
+                    ler_conexao(id);
+            }
+        }
+
+        // Bytes que ficaram nas conexoes por falta de espaco na fila de entrada
+        enviar_lotes();
+        for (int i = 0; i < MAX_CONEXOES && entrada_contador < TAM_ENTRADA; i++)
+            if (conexoes[i].fd != -1 && conexoes[i].n_entrada >= TAM_QUADRO(INJECAO_TAM_PEDIDO))
+                interpretar_pedidos(i);
+        enviar_lotes();
+
+        double agora = relogio_real();
+        if (agora >= proximo_relatorio) {
+            if (pedidos_respondidos > respondidos_relatorio)
+                printf("[Servico] %.0f pedidos/s (%llu respondidos)\n",
+                       (pedidos_respondidos - respondidos_relatorio) / PERIODO_RELATORIO, pedidos_respondidos);
+            respondidos_relatorio = pedidos_respondidos;
+            proximo_relatorio = agora + PERIODO_RELATORIO;
+        }
+    }
+    return 0;
+}
+
+
+/* === CICLO DE VIDA === */
+int injecao_iniciar(const char* caminho, int n_andares, FuncaoInjetar funcao)
+{
+    struct sockaddr_un endereco = {.sun_family = AF_UNIX};
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        printf("Erro: caminho do socket de servico muito longo: %s\n", caminho);
+        return FALSE;
+    }
+    strcpy(endereco.sun_path, caminho);
+    strcpy(caminho_socket, caminho);
+
+    fd_servidor = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    unlink(caminho);
+    if (fd_servidor < 0
+        || bind(fd_servidor, (struct sockaddr*)&endereco, sizeof(endereco)) != 0
+        || listen(fd_servidor, MAX_CONEXOES) != 0) {
+        printf("Erro: nao foi possivel abrir o socket de servico %s\n", caminho);
+        if (fd_servidor >= 0)
+            close(fd_servidor);
+        return FALSE;
+    }
+
+    fd_epoll = epoll_create1(0);
+    fd_respostas = eventfd(0, EFD_NONBLOCK);
+    struct epoll_event ev_servidor = {.events = EPOLLIN, .data.u32 = ID_SERVIDOR};
+    struct epoll_event ev_respostas = {.events = EPOLLIN, .data.u32 = ID_RESPOSTAS};
+    if (fd_epoll < 0 || fd_respostas < 0
+        || epoll_ctl(fd_epoll, EPOLL_CTL_ADD, fd_servidor, &ev_servidor) != 0
+        || epoll_ctl(fd_epoll, EPOLL_CTL_ADD, fd_respostas, &ev_respostas) != 0) {
+        printf("Erro: nao foi possivel preparar o epoll do servico %s\n", caminho);
+        if (fd_epoll >= 0)
+            close(fd_epoll);
+        if (fd_respostas >= 0)
+            close(fd_respostas);
+        close(fd_servidor);
+        unlink(caminho);
+        fd_servidor = fd_epoll = fd_respostas = -1;
+        return FALSE;
+    }
+
+    for (int i = 0; i < MAX_CONEXOES; i++)
+        conexoes[i].fd = -1;
+    for (int i = 0; i < MAX_PENDENTES; i++)
+        livres[i] = MAX_PENDENTES - 1 - i;
+    n_livres = MAX_PENDENTES;
+    andares = n_andares;
+    injetar = funcao;
+
+    __atomic_store_n(&injecao_ativa, TRUE, __ATOMIC_RELEASE);
+    pthread_create(&thread_injecao, NULL, funcao_injecao, NULL);
+    return TRUE;
+}
+
+void injecao_finalizar(void)
+{
+    if (!__atomic_load_n(&injecao_ativa, __ATOMIC_ACQUIRE))
+        return;
+    __atomic_store_n(&injecao_ativa, FALSE, __ATOMIC_RELEASE);
+    uint64_t um = 1;
+    if (write(fd_respostas, &um, sizeof(um)) < 0)
+        perror("[Servico] eventfd");
+    pthread_join(thread_injecao, NULL);
+
+    for (int i = 0; i < MAX_CONEXOES; i++)
+        if (conexoes[i].fd != -1)
+            fechar_conexao(i);
+    close(fd_servidor);
+    close(fd_epoll);
+    close(fd_respostas);
+    unlink(caminho_socket);
+
+    double duracao = ultima_resposta - inicio_pedidos;
+    if (pedidos_respondidos > 0 && duracao > 0)
+        printf("[Servico] %llu pedidos respondidos em %.1fs: %.0f pedidos/s sustentados\n",
+               pedidos_respondidos, duracao, pedidos_respondidos / duracao);
+}
@@ -0,0 +1,39 @@
+#ifndef INJECAO_H
+#define INJECAO_H
+
+#include <stdint.h>
+
+/* === INJECAO EXTERNA DE CHAMADAS (socket Unix, mensagens binarias) === */
+// Cada mensagem e um quadro: uint32 com o tamanho do corpo seguido do corpo.
+// Inteiros e float na ordem de bytes da maquina (o socket e local).
+//   pedido:   uint32 id, int32 origem, int32 destino
+//   resposta: uint32 id, int32 elevador, float eta (s ate o elevador chegar a origem)
+#define INJECAO_TAM_PEDIDO 12
+#define INJECAO_TAM_RESPOSTA 12
+
+// Valores de elevador na resposta alem dos ids da frota
+#define INJECAO_SEM_ELEVADOR -1     // Nenhum elevador pode receber a chamada agora
+#define INJECAO_PEDIDO_INVALIDO -2  // Andares fora do edificio ou origem igual ao destino
+
+typedef struct
+{
+    uint32_t id;
+    int origem;
+    int destino;
+    int pedido;     // Referencia a devolver em injecao_responder
+} ChamadaExterna;
+
+// Insere um lote de chamadas no buffer do scheduler. Retorna quantas, a partir
+// do inicio do lote, foram aceitas (as demais sao reenviadas depois).
+typedef int (*FuncaoInjetar)(const ChamadaExterna* lote, int n);
+
+// Abre o socket e cria a thread de E/S (epoll, nao bloqueante)
+int injecao_iniciar(const char* caminho, int n_andares, FuncaoInjetar injetar);
+
+// Encerra a thread, fecha as conexoes e imprime a taxa sustentada de pedidos
+void injecao_finalizar(void);
+
+// Chamado pelo scheduler ao decidir um pedido externo (thread-safe, nao bloqueia)
+void injecao_responder(int pedido, int elevador, double eta);
+
+#endif
@@ -0,0 +1,494 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "lote.h"
+#include "aleatorio.h"
+#include "trafego.h"
+#include "deterministico.h"
+#include "relogio.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define FILA_LOTE 8                 // Mesma fila de trechos do motor deterministico
+// Replicas por vetor na varredura: a largura do registro do alvo da compilacao
+#if defined(__AVX512F__)
+#define LANES_LOTE 16
+#elif defined(__AVX2__)
+#define LANES_LOTE 8
+#else
+#define LANES_LOTE 4
+#endif
+#define LARGURA_LOTE 16             // Replicas arredondadas para multiplo: vetores inteiros
+#define ALINHAMENTO_LOTE 64         // Linha de cache
+#define FAIXAS_ESPERA_LOTE 4096     // Histograma das esperas: faixas de 0.25s ate 1024s,
+#define LARGURA_FAIXA_LOTE 0.25     // mais uma faixa para o que passar disso
+
+
+/* === ESTRUTURAS DE DADOS === */
+// Vetores de LANES_LOTE replicas (extensao de vetores do gcc): SSE2 no x86-64 basico,
+// AVX2 ou AVX-512 com -march=native. Comparacoes geram mascaras (-1 ou 0 por replica).
+typedef float VetorLote __attribute__((vector_size(LANES_LOTE * sizeof(float))));
+typedef int32_t MascaraLote __attribute__((vector_size(LANES_LOTE * sizeof(int32_t))));
+
+// Estado de um elevador numa replica, tocado so quando uma parada dele termina ou
+// uma chamada da replica e despachada
+typedef struct
+{
+    double fim;                 // Fim da parada em curso (ocioso: instante em que ficou livre)
+    double instante;            // Despacho do trecho atual
+    double t_livre;             // Modelo de ETA: livre apos as paradas comprometidas
+    int fase;                   // 0: ocioso, 1: indo a origem, 2: indo ao destino
+    int andar;                  // Ultima parada
+    int origem;
+    int destino;
+    int andar_livre;
+    int fila_inicio;
+    int fila_contador;
+    int fila_origem[FILA_LOTE];
+    int fila_destino[FILA_LOTE];
+    double fila_instante[FILA_LOTE];
+} CarroLote;
+
+typedef struct
+{
+    Aleatorio rng;              // Mesmo fluxo do motor deterministico com semente + r
+    double proxima;             // Instante da proxima chamada (INFINITY: acabou)
+} AndarLote;
+
+typedef struct
+{
+    int geradas;
+    int concluidas;
+    int descartadas;
+    int embarques;
+    double espera_total;
+    int andar_proximo;          // Andar da proxima chamada (menor indice no empate)
+} ReplicaLote;
+
+// Os campos varridos a cada passo ficam em vetores sobre as replicas (elevador k em
+// [k * largura + r]); o resto fica agrupado por replica (elevador k em
+// [r * n_elevadores + k], andar a em [r * n_andares + a]), perto do que o evento usa
+typedef struct
+{
+    const Predio* predio;
+    int n;                      // Replicas
+    int largura;                // n arredondado para LARGURA_LOTE
+    int restantes;              // Replicas que ainda tem chamadas por gerar ou concluir
+    unsigned long long paradas;
+
+    // Varridos
+    float* fim_parada;          // CarroLote.fim arredondado para baixo, INFINITY se ocioso
+    float* proxima_chamada;     // Menor AndarLote.proxima da replica, arredondada para baixo
+    int32_t* marcado;           // Saida da varredura
+
+    CarroLote* carros;
+    AndarLote* andares;
+    ReplicaLote* replicas;
+
+    unsigned long long faixas[FAIXAS_ESPERA_LOTE + 1];
+    double espera_max;
+} Lote;
+
+
+/* === ALOCACAO === */
+// Bloco zerado e alinhado a linha de cache
+static void* alocar_alinhado(size_t tam)
+{
+    tam = (tam + ALINHAMENTO_LOTE - 1) / ALINHAMENTO_LOTE * ALINHAMENTO_LOTE;
+    void* p = aligned_alloc(ALINHAMENTO_LOTE, tam);
+    if (p != NULL)
+        memset(p, 0, tam);
+    return p;
+}
+
+static void liberar_lote(Lote* l)
+{
+    free(l->fim_parada);
+    free(l->proxima_chamada);
+    free(l->marcado);
+    free(l->carros);
+    free(l->andares);
+    free(l->replicas);
+}
+
+static int alocar_lote(Lote* l)
+{
+    const Predio* p = l->predio;
+    size_t R = l->largura;
+    l->fim_parada = alocar_alinhado(p->n_elevadores * R * sizeof(float));
+    l->proxima_chamada = alocar_alinhado(R * sizeof(float));
+    l->marcado = alocar_alinhado(R * sizeof(int32_t));
+    l->carros = alocar_alinhado(R * p->n_elevadores * sizeof(CarroLote));
+    l->andares = alocar_alinhado(R * p->n_andares * sizeof(AndarLote));
+    l->replicas = alocar_alinhado(R * sizeof(ReplicaLote));
+    return l->fim_parada != NULL && l->proxima_chamada != NULL && l->marcado != NULL && l->carros != NULL
+           && l->andares != NULL && l->replicas != NULL;
+}
+
+
+/* === EVENTOS (fora do laco vetorial) === */
+static double viagem(const Predio* p, int k, int de, int para)
+{
+    const ConfigElevador* e = &p->elevadores[k];
+    return fabs(p->cota[para] - p->cota[de]) / e->velocidade + e->tempo_porta;
+}
+
+static CarroLote* carro(Lote* l, int k, int r)
+{
+    return &l->carros[r * l->predio->n_elevadores + k];
+}
+
+static void verificar_fim(Lote* l, int r)
+{
+    const ReplicaLote* rep = &l->replicas[r];
+    int n_chamadas = l->predio->n_chamadas;
+    if (rep->geradas == n_chamadas && rep->concluidas + rep->descartadas == n_chamadas)
+        l->restantes--;
+}
+
+// Nova parada do elevador ao fim de uma viagem
+static void parar_em(Lote* l, int k, int r, double fim)
+{
+    carro(l, k, r)->fim = fim;
+    l->fim_parada[k * l->largura + r] = nextafterf((float)fim, -INFINITY);
+}
+
+// Proximo trecho da fila do elevador, partindo no instante inicio
+static void iniciar_trecho(Lote* l, int k, int r, double inicio)
+{
+    CarroLote* c = carro(l, k, r);
+    c->origem = c->fila_origem[c->fila_inicio];
+    c->destino = c->fila_destino[c->fila_inicio];
+    c->instante = c->fila_instante[c->fila_inicio];
+    c->fila_inicio = (c->fila_inicio + 1) % FILA_LOTE;
+    c->fila_contador--;
+    c->fase = 1;
+    parar_em(l, k, r, inicio + viagem(l->predio, k, c->andar, c->origem));
+}
+
+// Menor ETA entre os elevadores com fila livre, como eta_melhor_elevador_em, no
+// instante da chamada
+static void despachar(Lote* l, int r, int origem, int destino, double instante)
+{
+    const Predio* p = l->predio;
+    int melhor = -1;
+    double menor = 0;
+    for (int k = 0; k < p->n_elevadores; k++) {
+        const CarroLote* c = carro(l, k, r);
+        int limite = p->elevadores[k].capacidade < FILA_LOTE ? p->elevadores[k].capacidade : FILA_LOTE;
+        if (c->fila_contador >= limite)
+            continue;
+        double partida = c->t_livre > instante ? c->t_livre : instante;
+        double eta = partida + viagem(p, k, c->andar_livre, origem);
+        if (melhor == -1 || eta < menor) {
+            melhor = k;
+            menor = eta;
+        }
+    }
+    if (melhor == -1) {
+        l->replicas[r].descartadas++;
+        verificar_fim(l, r);
+        return;
+    }
+
+    CarroLote* c = carro(l, melhor, r);
+    int q = (c->fila_inicio + c->fila_contador) % FILA_LOTE;
+    c->fila_origem[q] = origem;
+    c->fila_destino[q] = destino;
+    c->fila_instante[q] = instante;
+    c->fila_contador++;
+    c->t_livre = menor + viagem(p, melhor, origem, destino);
+    c->andar_livre = destino;
+    if (c->fase == 0)
+        iniciar_trecho(l, melhor, r, c->fim > instante ? c->fim : instante);
+}
+
+// Proxima chamada do andar, despachada no proprio instante
+static void gerar_chamada(Lote* l, int r, int a)
+{
+    const Predio* p = l->predio;
+    ReplicaLote* rep = &l->replicas[r];
+    AndarLote* andar = &l->andares[r * p->n_andares + a];
+    if (rep->geradas == p->n_chamadas) {
+        andar->proxima = INFINITY;
+        return;
+    }
+    int destino = trafego_destino(&p->trafego, &andar->rng, a, p->n_andares);
+    rep->geradas++;
+    despachar(l, r, a, destino, andar->proxima);
+    andar->proxima += trafego_intervalo(&p->trafego, &andar->rng, a);
+}
+
+// Parada do elevador terminada, no instante exato: embarque na origem ou conclusao no
+// destino
+static void tratar_parada(Lote* l, int k, int r)
+{
+    CarroLote* c = carro(l, k, r);
+    ReplicaLote* rep = &l->replicas[r];
+    double agora = c->fim;
+    l->paradas++;
+    if (c->fase == 1) {
+        double espera = agora - c->instante;
+        int faixa = (int)(espera / LARGURA_FAIXA_LOTE);
+        l->faixas[faixa < FAIXAS_ESPERA_LOTE ? faixa : FAIXAS_ESPERA_LOTE]++;
+        if (espera > l->espera_max)
+            l->espera_max = espera;
+        rep->espera_total += espera;
+        rep->embarques++;
+        c->andar = c->origem;
+        c->fase = 2;
+        parar_em(l, k, r, agora + viagem(l->predio, k, c->origem, c->destino));
+        return;
+    }
+
+    c->andar = c->destino;
+    rep->concluidas++;
+    verificar_fim(l, r);
+    if (c->fila_contador > 0) {
+        iniciar_trecho(l, k, r, agora);
+    } else {
+        c->fase = 0;
+        c->t_livre = agora;
+        c->andar_livre = c->andar;
+        l->fim_parada[k * l->largura + r] = INFINITY;
+    }
+}
+
+// Andar com a proxima chamada da replica (o de menor indice no empate)
+static int proximo_andar(const Lote* l, int r)
+{
+    const AndarLote* andares = &l->andares[r * l->predio->n_andares];
+    int a_min = 0;
+    for (int a = 1; a < l->predio->n_andares; a++)
+        if (andares[a].proxima < andares[a_min].proxima)
+            a_min = a;
+    return a_min;
+}
+
+// Paradas e chamadas da replica ate t, em ordem de tempo. Empates como na fila de
+// eventos do motor deterministico: paradas antes de chamadas, depois pelo menor indice
+static void tratar_replica(Lote* l, int r, double t)
+{
+    const Predio* p = l->predio;
+    const AndarLote* andares = &l->andares[r * p->n_andares];
+    int a_min = l->replicas[r].andar_proximo;
+    while (TRUE) {
+        int k_min = -1;
+        double fim_min = INFINITY;
+        for (int k = 0; k < p->n_elevadores; k++) {
+            const CarroLote* c = carro(l, k, r);
+            if (c->fase != 0 && c->fim < fim_min) {
+                k_min = k;
+                fim_min = c->fim;
+            }
+        }
+
+        double proxima_min = andares[a_min].proxima;
+        if (k_min != -1 && fim_min <= t && fim_min <= proxima_min) {
+            tratar_parada(l, k_min, r);
+        } else if (proxima_min <= t) {
+            gerar_chamada(l, r, a_min);
+            a_min = proximo_andar(l, r);
+        } else {
+            l->replicas[r].andar_proximo = a_min;
+            l->proxima_chamada[r] = nextafterf((float)proxima_min, -INFINITY);
+            return;
+        }
+    }
+}
+
+
+/* === VARREDURA (laco vetorial) === */
+// Marca em marcado os elementos de valores <= limite (com acumular, somando-se as marcas
+// que ja estavam la) e retorna quantos ficaram marcados. Sem desvios por replica:
+// LANES_LOTE replicas por instrucao.
+static int varrer(int n, const float* valores, float limite, int32_t* marcado, int acumular)
+{
+    VetorLote vlimite = (VetorLote){0} + limite;
+    MascaraLote contagem = {0};
+    for (int r = 0; r < n; r += LANES_LOTE) {
+        MascaraLote m = *(const VetorLote*)&valores[r] <= vlimite;
+        if (acumular)
+            m |= *(MascaraLote*)&marcado[r];
+        *(MascaraLote*)&marcado[r] = m;
+        contagem -= m;
+    }
+    int total = 0;
+    for (int i = 0; i < LANES_LOTE; i++)
+        total += contagem[i];
+    return total;
+}
+
+// Algum elemento da mascara ligado
+static int qualquer(MascaraLote m)
+{
+    int32_t ou = 0;
+    for (int i = 0; i < LANES_LOTE; i++)
+        ou |= m[i];
+    return ou != 0;
+}
+
+/* === EXECUCAO === */
+static double percentil(const Lote* l, double q, long long total)
+{
+    long long posicao = (long long)ceil(q * total);
+    long long acumulado = 0;
+    for (int f = 0; f < FAIXAS_ESPERA_LOTE; f++) {
+        acumulado += l->faixas[f];
+        if (acumulado >= posicao)
+            return (f + 1) * LARGURA_FAIXA_LOTE < l->espera_max ? (f + 1) * LARGURA_FAIXA_LOTE : l->espera_max;
+    }
+    return l->espera_max;
+}
+
+// Media e meia largura do intervalo de 95% (normal) das esperas medias das replicas
+static void media_replicas(const double* valores, int n, double* media, double* meia_largura)
+{
+    double soma = 0, soma_quadrados = 0;
+    for (int r = 0; r < n; r++) {
+        soma += valores[r];
+        soma_quadrados += valores[r] * valores[r];
+    }
+    *media = soma / n;
+    double variancia = n > 1 ? (soma_quadrados - n * *media * *media) / (n - 1) : 0;
+    *meia_largura = 1.96 * sqrt(variancia > 0 ? variancia : 0) / sqrt(n);
+}
+
+// Mesmas sementes no motor deterministico (sem estacionamento), uma execucao por vez
+static int comparar_escalar(const Predio* predio, int n, uint64_t semente, double* medias, double* duracao)
+{
+    Predio copia = *predio;
+    copia.politica.estacionamento = FALSE;
+    double inicio = relogio_agora();
+    for (int r = 0; r < n; r++) {
+        ResultadoDet resultado;
+        if (!deterministico_simular_predio(&copia, semente + r, &resultado)) {
+            deterministico_finalizar();
+            return FALSE;
+        }
+        medias[r] = resultado.espera_media;
+    }
+    *duracao = relogio_agora() - inicio;
+    deterministico_finalizar();
+    return TRUE;
+}
+
+int lote_executar(const Predio* predio, int n_replicas, uint64_t semente, double passo, int comparar)
+{
+    if (predio->n_zonas > 0 || predio->politica.zonas_uniformes != 1 || predio->n_andares > LOTE_MAX_ANDARES
+        || predio->n_elevadores > LOTE_MAX_ELEVADORES) {
+        printf("Erro: o motor em lote aceita uma zona, ate %d andares e ate %d elevadores\n", LOTE_MAX_ANDARES,
+               LOTE_MAX_ELEVADORES);
+        return FALSE;
+    }
+    if (n_replicas < 1 || n_replicas > LOTE_MAX_REPLICAS || passo <= 0) {
+        printf("Erro: lote requer de 1 a %d replicas e passo positivo\n", LOTE_MAX_REPLICAS);
+        return FALSE;
+    }
+
+    Lote* l = calloc(1, sizeof(Lote));
+    if (l == NULL) {
+        printf("Erro: sem memoria para o lote\n");
+        return FALSE;
+    }
+    l->predio = predio;
+    l->n = n_replicas;
+    l->largura = (n_replicas + LARGURA_LOTE - 1) / LARGURA_LOTE * LARGURA_LOTE;
+    l->restantes = n_replicas;
+    if (!alocar_lote(l)) {
+        printf("Erro: sem memoria para o lote de %d replicas\n", n_replicas);
+        liberar_lote(l);
+        free(l);
+        return FALSE;
+    }
+
+    // Replicas de enchimento (r >= n) nunca geram chamadas; elevadores comecam ociosos
+    // no terreo
+    int R = l->largura;
+    for (int r = 0; r < R; r++) {
+        for (int a = 0; a < predio->n_andares; a++) {
+            AndarLote* andar = &l->andares[r * predio->n_andares + a];
+            aleatorio_semear(&andar->rng, semente + r, a);
+            andar->proxima = r < n_replicas ? 0 : INFINITY;
+        }
+        l->proxima_chamada[r] = r < n_replicas ? 0 : INFINITY;
+    }
+    for (int i = 0; i < predio->n_elevadores * R; i++)
+        l->fim_parada[i] = INFINITY;
+
+    printf("[Lote] %d replicas (sementes %llu a %llu), %d andares, %d elevadores, passo de %.3fs\n", n_replicas,
+           (unsigned long long)semente, (unsigned long long)(semente + n_replicas - 1), predio->n_andares,
+           predio->n_elevadores, passo);
+
+    // Cada passo: paradas terminadas e chamadas ate t. A varredura vetorial acha as
+    // replicas com algo a tratar; o tratamento usa os instantes exatos, em ordem.
+    double inicio = relogio_agora();
+    long long passos = 0;
+    double t = 0;
+    for (long long i = 0; l->restantes > 0; i++) {
+        t = i * passo;
+        float limite = nextafterf((float)t, INFINITY);
+        int marcadas = varrer(R, l->proxima_chamada, limite, l->marcado, FALSE);
+        for (int k = 0; k < predio->n_elevadores; k++)
+            marcadas = varrer(R, &l->fim_parada[k * R], limite, l->marcado, TRUE);
+        if (marcadas > 0) {
+            for (int r = 0; r < R; r += LANES_LOTE)
+                if (qualquer(*(MascaraLote*)&l->marcado[r]))
+                    for (int j = r; j < r + LANES_LOTE; j++)
+                        if (l->marcado[j])
+                            tratar_replica(l, j, t);
+        }
+        passos++;
+    }
+    double duracao = relogio_agora() - inicio;
+
+    // Relatorio
+    long long geradas = 0, concluidas = 0, descartadas = 0, embarques = 0;
+    double* medias = malloc(2 * n_replicas * sizeof(double));
+    if (medias == NULL) {
+        printf("Erro: sem memoria para o relatorio do lote\n");
+        liberar_lote(l);
+        free(l);
+        return FALSE;
+    }
+    for (int r = 0; r < n_replicas; r++) {
+        const ReplicaLote* rep = &l->replicas[r];
+        geradas += rep->geradas;
+        concluidas += rep->concluidas;
+        descartadas += rep->descartadas;
+        embarques += rep->embarques;
+        medias[r] = rep->embarques > 0 ? rep->espera_total / rep->embarques : 0;
+    }
+    double media, meia_largura;
+    media_replicas(medias, n_replicas, &media, &meia_largura);
+
+    printf("\n=== LOTE FINALIZADO ===\n");
+    printf("Tempo simulado: %.1fs (%lld passos, %llu paradas)\n", t, passos, l->paradas);
+    printf("Chamadas: %lld geradas, %lld concluidas, %lld descartadas\n", geradas, concluidas, descartadas);
+    printf("Espera media ate o embarque: %.2fs +- %.2fs entre replicas; p50 %.2fs, p95 %.2fs, p99 %.2fs\n", media,
+           meia_largura, percentil(l, 0.50, embarques), percentil(l, 0.95, embarques),
+           percentil(l, 0.99, embarques));
+    printf("Vazao: %.3fs (%.0f replicas/s, %d replicas por vetor)\n", duracao,
+           duracao > 0 ? n_replicas / duracao : 0.0, LANES_LOTE);
+
+    int ok = TRUE;
+    if (comparar) {
+        double duracao_escalar;
+        ok = comparar_escalar(predio, n_replicas, semente, &medias[n_replicas], &duracao_escalar);
+        if (ok) {
+            double media_escalar, meia_escalar;
+            media_replicas(&medias[n_replicas], n_replicas, &media_escalar, &meia_escalar);
+            printf("Motor deterministico, mesmas sementes sem estacionamento: %.3fs (%.0f replicas/s), "
+                   "espera media %.2fs +- %.2fs\n", duracao_escalar,
+                   duracao_escalar > 0 ? n_replicas / duracao_escalar : 0.0, media_escalar, meia_escalar);
+            printf("Ganho do lote: %.1fx\n", duracao > 0 ? duracao_escalar / duracao : 0.0);
+        }
+    }
+
+    free(medias);
+    liberar_lote(l);
+    free(l);
+    return ok;
+}
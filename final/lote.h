@@ -0,0 +1,27 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include <stdint.h>
+#include "config.h"
+
+/* === MOTOR EM LOTE (replicas em passo unico) === */
+// Simula n replicas do mesmo predio pequeno, com sementes semente, semente+1, ..., num
+// unico laco de tempo em passos fixos. Cada elevador guarda o instante exato em que a
+// parada em curso termina, e cada replica o da proxima chamada. Esses instantes ficam em
+// vetores sobre as replicas e sao varridos a cada passo, varias replicas por instrucao;
+// so as replicas marcadas tratam seus eventos, no instante exato, com o estado frio
+// agrupado por replica.
+//
+// Modelo: o do motor deterministico sem estacionamento, numa zona so (mesmo trafego por
+// semente, despacho pelo menor ETA em atendimento sequencial, filas de 8 trechos). Os
+// eventos de um passo sao tratados em ordem de tempo, com os desempates da fila de
+// eventos daquele motor: os resultados sao os dele em qualquer passo.
+#define LOTE_MAX_ANDARES 64
+#define LOTE_MAX_ELEVADORES 16
+#define LOTE_MAX_REPLICAS 1000000
+
+// Retorna FALSE se o predio nao couber no modelo ou faltar memoria. Com comparar, roda
+// tambem as mesmas sementes no motor deterministico, uma a uma, para comparar a vazao.
+int lote_executar(const Predio* predio, int n_replicas, uint64_t semente, double passo, int comparar);
+
+#endif
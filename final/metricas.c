@@ -0,0 +1,339 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "metricas.h"
+#include "relogio.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define LER(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define GRAVAR(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+#define SOMAR(x, v) __atomic_fetch_add(&(x), (v), __ATOMIC_RELAXED)
+
+
+/* === ESTRUTURAS DE DADOS === */
+// Estado publicado de um elevador (um escritor por campo: a thread que faz a transicao)
+typedef struct
+{
+    int andar;
+    int destino;
+    int fila;
+    int ocupado;
+    uint64_t atendidas;
+} MetricasElevador;
+
+typedef struct
+{
+    uint64_t baldes[METRICAS_BALDES];
+    uint64_t soma_us;   // Soma em microssegundos (contador inteiro atomico)
+} HistogramaLatencia;
+
+
+/* === VARIAVEIS GLOBAIS === */
+static const double limites_baldes[METRICAS_BALDES - 1] = {
+    0.25, 0.5, 1, 2, 3, 5, 7.5, 10, 15, 20, 30, 60, 120
+};
+
+static MetricasElevador* elevadores = NULL;
+static int n_elevadores = 0;
+static int* aguardando = NULL;
+static int n_andares = 0;
+
+static uint64_t geradas, despachadas, descartadas;
+static int backlog;
+static HistogramaLatencia espera, viagem;
+
+// Servidor
+static int socket_servidor = -1;
+static char caminho_socket[sizeof(((struct sockaddr_un*)0)->sun_path)];
+static int servidor_ativo = FALSE;      // Lido sem trava pela thread do servidor (atomicos)
+static pthread_t thread_servidor;
+
+
+/* === CICLO DE VIDA === */
+int metricas_iniciar(int n, int andares)
+{
+    elevadores = calloc(n, sizeof(MetricasElevador));
+    aguardando = calloc(andares, sizeof(int));
+    if (elevadores == NULL || aguardando == NULL) {
+        printf("Erro: sem memoria para as metricas\n");
+        return FALSE;
+    }
+    n_elevadores = n;
+    n_andares = andares;
+    return TRUE;
+}
+
+// Encerra o servidor. Chamado depois do join de todas as threads da simulacao: nada mais
+// publica, e os contadores ficam legiveis para o relatorio final
+void metricas_finalizar(void)
+{
+    if (__atomic_load_n(&servidor_ativo, __ATOMIC_ACQUIRE)) {
+        __atomic_store_n(&servidor_ativo, FALSE, __ATOMIC_RELEASE);
+        pthread_join(thread_servidor, NULL);
+        close(socket_servidor);
+        unlink(caminho_socket);
+        socket_servidor = -1;
+    }
+}
+
+
+/* === PUBLICACAO === */
+void metricas_chamada_gerada(void) { SOMAR(geradas, 1); }
+void metricas_chamada_despachada(void) { SOMAR(despachadas, 1); }
+void metricas_chamada_descartada(void) { SOMAR(descartadas, 1); }
+void metricas_backlog(int chamadas_no_buffer) { GRAVAR(backlog, chamadas_no_buffer); }
+
+void metricas_elevador_andar(int id, int andar)
+{
+    GRAVAR(elevadores[id].andar, andar);
+    GRAVAR(elevadores[id].destino, andar);
+}
+
+void metricas_elevador_trecho(int id, int destino)
+{
+    GRAVAR(elevadores[id].destino, destino);
+}
+
+void metricas_elevador_fila(int id, int fila, int ocupado)
+{
+    GRAVAR(elevadores[id].fila, fila);
+    GRAVAR(elevadores[id].ocupado, ocupado);
+}
+
+void metricas_elevador_atendida(int id)
+{
+    SOMAR(elevadores[id].atendidas, 1);
+}
+
+void metricas_andar_aguardando(int andar, int delta)
+{
+    SOMAR(aguardando[andar], delta);
+}
+
+static void registrar_latencia(HistogramaLatencia* h, double segundos)
+{
+    int k = 0;
+    while (k < METRICAS_BALDES - 1 && segundos > limites_baldes[k])
+        k++;
+    SOMAR(h->baldes[k], 1);
+    SOMAR(h->soma_us, (uint64_t)(segundos * 1e6));
+}
+
+void metricas_espera(double segundos) { registrar_latencia(&espera, segundos); }
+void metricas_viagem(double segundos) { registrar_latencia(&viagem, segundos); }
+
+
+/* === RETRATO === */
+// Percentil p por interpolacao linear dentro do balde (o balde +Inf devolve o limite inferior)
+double metricas_percentil(const unsigned long long* baldes, double p)
+{
+    unsigned long long contagem = 0;
+    for (int k = 0; k < METRICAS_BALDES; k++)
+        contagem += baldes[k];
+    if (contagem == 0)
+        return 0;
+    double alvo = p * contagem;
+    unsigned long long acumulado = 0;
+    for (int k = 0; k < METRICAS_BALDES; k++) {
+        if (baldes[k] > 0 && acumulado + baldes[k] >= alvo) {
+            double inferior = k == 0 ? 0 : limites_baldes[k - 1];
+            if (k == METRICAS_BALDES - 1)
+                return inferior;
+            return inferior + (limites_baldes[k] - inferior) * (alvo - acumulado) / baldes[k];
+        }
+        acumulado += baldes[k];
+    }
+    return limites_baldes[METRICAS_BALDES - 2];
+}
+
+static void escrever_histograma(FILE* f, const char* nome, const char* ajuda, HistogramaLatencia* h)
+{
+    // Copia os baldes primeiro: a contagem do retrato e a soma dos baldes copiados
+    unsigned long long baldes[METRICAS_BALDES];
+    unsigned long long contagem = 0;
+    for (int k = 0; k < METRICAS_BALDES; k++) {
+        baldes[k] = LER(h->baldes[k]);
+        contagem += baldes[k];
+    }
+
+    fprintf(f, "# HELP %s %s\n# TYPE %s histogram\n", nome, ajuda, nome);
+    unsigned long long acumulado = 0;
+    for (int k = 0; k < METRICAS_BALDES - 1; k++) {
+        acumulado += baldes[k];
+        fprintf(f, "%s_bucket{le=\"%g\"} %llu\n", nome, limites_baldes[k], acumulado);
+    }
+    fprintf(f, "%s_bucket{le=\"+Inf\"} %llu\n", nome, contagem);
+    fprintf(f, "%s_sum %.6f\n", nome, LER(h->soma_us) / 1e6);
+    fprintf(f, "%s_count %llu\n", nome, contagem);
+
+    fprintf(f, "# HELP %s_percentil Percentis estimados a partir do histograma\n# TYPE %s_percentil gauge\n", nome, nome);
+    const double ps[] = {0.5, 0.9, 0.99};
+    for (int i = 0; i < 3; i++)
+        fprintf(f, "%s_percentil{p=\"%g\"} %.3f\n", nome, ps[i], metricas_percentil(baldes, ps[i]));
+}
+
+// Escreve o retrato. t_anterior/geradas_anterior guardam a amostra do retrato anterior
+// para a taxa de chamadas (a primeira taxa e a media desde o inicio).
+static void escrever_retrato(FILE* f, double* t_anterior, uint64_t* geradas_anterior)
+{
+    double agora = relogio_agora();
+    uint64_t g = LER(geradas);
+    double taxa = agora > *t_anterior ? (g - *geradas_anterior) / (agora - *t_anterior) : 0;
+    *t_anterior = agora;
+    *geradas_anterior = g;
+
+    fprintf(f, "# HELP elevador_tempo_simulacao_segundos Relogio da simulacao\n"
+               "# TYPE elevador_tempo_simulacao_segundos gauge\n"
+               "elevador_tempo_simulacao_segundos %.3f\n", agora);
+    fprintf(f, "# HELP elevador_chamadas_geradas_total Chamadas geradas pelos andares\n"
+               "# TYPE elevador_chamadas_geradas_total counter\n"
+               "elevador_chamadas_geradas_total %llu\n", (unsigned long long)g);
+    fprintf(f, "# HELP elevador_chamadas_despachadas_total Trechos designados a um elevador\n"
+               "# TYPE elevador_chamadas_despachadas_total counter\n"
+               "elevador_chamadas_despachadas_total %llu\n", (unsigned long long)LER(despachadas));
+    fprintf(f, "# HELP elevador_chamadas_descartadas_total Trechos sem elevador disponivel\n"
+               "# TYPE elevador_chamadas_descartadas_total counter\n"
+               "elevador_chamadas_descartadas_total %llu\n", (unsigned long long)LER(descartadas));
+    fprintf(f, "# HELP elevador_chamadas_por_segundo Chamadas geradas por segundo desde o retrato anterior\n"
+               "# TYPE elevador_chamadas_por_segundo gauge\n"
+               "elevador_chamadas_por_segundo %.3f\n", taxa);
+    fprintf(f, "# HELP elevador_backlog_chamadas Chamadas aguardando o scheduler no buffer\n"
+               "# TYPE elevador_backlog_chamadas gauge\n"
+               "elevador_backlog_chamadas %d\n", LER(backlog));
+
+    fprintf(f, "# HELP elevador_andar Andar atual de cada elevador\n# TYPE elevador_andar gauge\n");
+    for (int i = 0; i < n_elevadores; i++)
+        fprintf(f, "elevador_andar{elevador=\"%d\"} %d\n", i, LER(elevadores[i].andar));
+    fprintf(f, "# HELP elevador_fila Chamadas designadas ainda nao iniciadas\n# TYPE elevador_fila gauge\n");
+    for (int i = 0; i < n_elevadores; i++)
+        fprintf(f, "elevador_fila{elevador=\"%d\"} %d\n", i, LER(elevadores[i].fila));
+    fprintf(f, "# HELP elevador_ocupado 1 se o elevador tem chamada em andamento ou na fila\n# TYPE elevador_ocupado gauge\n");
+    for (int i = 0; i < n_elevadores; i++)
+        fprintf(f, "elevador_ocupado{elevador=\"%d\"} %d\n", i, LER(elevadores[i].ocupado));
+    fprintf(f, "# HELP elevador_atendidas_total Trechos concluidos por elevador\n# TYPE elevador_atendidas_total counter\n");
+    for (int i = 0; i < n_elevadores; i++)
+        fprintf(f, "elevador_atendidas_total{elevador=\"%d\"} %llu\n", i,
+                (unsigned long long)LER(elevadores[i].atendidas));
+
+    fprintf(f, "# HELP elevador_aguardando Passageiros aguardando embarque por andar\n# TYPE elevador_aguardando gauge\n");
+    for (int a = 0; a < n_andares; a++)
+        fprintf(f, "elevador_aguardando{andar=\"%d\"} %d\n", a, LER(aguardando[a]));
+
+    escrever_histograma(f, "elevador_espera_segundos", "Espera do trecho ate o embarque", &espera);
+    escrever_histograma(f, "elevador_viagem_segundos", "Da chamada ate a chegada ao destino final", &viagem);
+}
+
+
+/* === LEITURA SEM TRAVAS === */
+void metricas_retrato(RetratoMetricas* r)
+{
+    r->tempo = relogio_agora();
+    r->geradas = LER(geradas);
+    r->despachadas = LER(despachadas);
+    r->descartadas = LER(descartadas);
+    r->backlog = LER(backlog);
+    for (int k = 0; k < METRICAS_BALDES; k++) {
+        r->espera[k] = LER(espera.baldes[k]);
+        r->viagem[k] = LER(viagem.baldes[k]);
+    }
+}
+
+void metricas_retrato_elevador(int id, RetratoElevador* e)
+{
+    e->andar = LER(elevadores[id].andar);
+    e->destino = LER(elevadores[id].destino);
+    e->fila = LER(elevadores[id].fila);
+    e->ocupado = LER(elevadores[id].ocupado);
+    e->atendidas = LER(elevadores[id].atendidas);
+}
+
+int metricas_aguardando(int andar)
+{
+    return LER(aguardando[andar]);
+}
+
+
+/* === SERVIDOR === */
+// Atende uma conexao por vez; o poll com timeout permite encerrar a thread sem sinais
+static void* funcao_servidor(void* arg)
+{
+    double t_anterior = relogio_agora();
+    uint64_t geradas_anterior = LER(geradas);
+    struct pollfd pfd = {.fd = socket_servidor, .events = POLLIN};
+
+    while (__atomic_load_n(&servidor_ativo, __ATOMIC_ACQUIRE)) {
+        if (poll(&pfd, 1, 200) <= 0)
+            continue;
+        int cliente = accept(socket_servidor, NULL, NULL);
+        if (cliente < 0)
+            continue;
+
+        // Cliente HTTP (curl --unix-socket, proxy do Prometheus) envia a requisicao logo;
+        // socat/nc apenas leem
+        char requisicao[256];
+        struct pollfd pc = {.fd = cliente, .events = POLLIN};
+        int http = FALSE;
+        if (poll(&pc, 1, 50) > 0) {
+            ssize_t n = read(cliente, requisicao, sizeof(requisicao) - 1);
+            http = n >= 3 && strncmp(requisicao, "GET", 3) == 0;
+        }
+
+        // Formata em memoria e envia com MSG_NOSIGNAL: um leitor que desiste antes do fim
+        // (timeout do curl, nc -z) da EPIPE aqui, sem SIGPIPE no processo
+        char* texto = NULL;
+        size_t tamanho = 0;
+        FILE* f = open_memstream(&texto, &tamanho);
+        if (f == NULL) {
+            close(cliente);
+            continue;
+        }
+        if (http)
+            fprintf(f, "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\n\r\n");
+        escrever_retrato(f, &t_anterior, &geradas_anterior);
+        fclose(f);
+        for (size_t enviados = 0; enviados < tamanho;) {
+            ssize_t n = send(cliente, texto + enviados, tamanho - enviados, MSG_NOSIGNAL);
+            if (n <= 0)
+                break;
+            enviados += n;
+        }
+        free(texto);
+        close(cliente);
+    }
+    return 0;
+}
+
+int metricas_servir(const char* caminho)
+{
+    struct sockaddr_un endereco = {.sun_family = AF_UNIX};
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        printf("Erro: caminho do socket de metricas muito longo: %s\n", caminho);
+        return FALSE;
+    }
+    strcpy(endereco.sun_path, caminho);
+    strcpy(caminho_socket, caminho);
+
+    socket_servidor = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(caminho);
+    if (socket_servidor < 0
+        || bind(socket_servidor, (struct sockaddr*)&endereco, sizeof(endereco)) != 0
+        || listen(socket_servidor, 8) != 0) {
+        printf("Erro: nao foi possivel abrir o socket de metricas %s\n", caminho);
+        if (socket_servidor >= 0)
+            close(socket_servidor);
+        socket_servidor = -1;
+        return FALSE;
+    }
+
+    __atomic_store_n(&servidor_ativo, TRUE, __ATOMIC_RELEASE);
+    pthread_create(&thread_servidor, NULL, funcao_servidor, NULL);
+    return TRUE;
+}
@@ -0,0 +1,63 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+/* === METRICAS AO VIVO (texto no formato do Prometheus via socket Unix) === */
+// As threads da simulacao publicam contadores com atomicos relaxados; o servidor
+// le um retrato deles a cada conexao, sem adquirir nenhuma trava da simulacao.
+// Limites (s) dos baldes do histograma de latencia; o ultimo balde e +Inf
+#define METRICAS_BALDES 14
+
+// Retrato dos contadores globais e dos histogramas (copias dos atomicos)
+typedef struct
+{
+    double tempo;
+    unsigned long long geradas;
+    unsigned long long despachadas;
+    unsigned long long descartadas;
+    int backlog;
+    unsigned long long espera[METRICAS_BALDES];
+    unsigned long long viagem[METRICAS_BALDES];
+} RetratoMetricas;
+
+typedef struct
+{
+    int andar;
+    int destino;        // Fim do trecho em curso (igual a andar se parado)
+    int fila;
+    int ocupado;
+    unsigned long long atendidas;
+} RetratoElevador;
+
+int metricas_iniciar(int n_elevadores, int n_andares);
+void metricas_finalizar(void);
+
+// Abre o socket e cria a thread servidora. Cada conexao recebe um retrato e e fechada;
+// clientes que enviam "GET ..." recebem a resposta com cabecalho HTTP.
+int metricas_servir(const char* caminho);
+
+// Publicacao (chamadas pelas threads da simulacao)
+void metricas_chamada_gerada(void);
+void metricas_chamada_despachada(void);
+void metricas_chamada_descartada(void);
+void metricas_backlog(int chamadas_no_buffer);
+void metricas_elevador_andar(int id, int andar);
+void metricas_elevador_trecho(int id, int destino);
+void metricas_elevador_fila(int id, int fila, int ocupado);
+void metricas_elevador_atendida(int id);
+
+// Passageiros aguardando embarque no andar (delta +1 na chamada, -1 no embarque ou descarte)
+void metricas_andar_aguardando(int andar, int delta);
+
+// Latencias (s): espera do trecho ate o embarque e viagem completa do passageiro
+void metricas_espera(double segundos);
+void metricas_viagem(double segundos);
+
+// Leitura sem travas (painel, servidor)
+void metricas_retrato(RetratoMetricas* r);
+void metricas_retrato_elevador(int id, RetratoElevador* e);
+int metricas_aguardando(int andar);
+
+// Percentil p de um histograma com os limites de METRICAS_BALDES (interpolado no balde)
+double metricas_percentil(const unsigned long long* baldes, double p);
+
+#endif
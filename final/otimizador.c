@@ -0,0 +1,291 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "otimizador.h"
+#include "config.h"
+#include "deterministico.h"
+#include "relogio.h"
+#include "aleatorio.h"
+#include "eta.h"
+#include "demanda.h"
+#include "zonas.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define N_PESOS 4               // distancia, carga, paradas, direcao (ETA fixo em 1)
+#define SUAVIZACAO 0.7          // Peso da elite na nova media e no novo desvio
+#define DESVIO_MINIMO 0.05      // Fracao do desvio inicial abaixo da qual nao encolhe
+#define ESPERA_DESCARTE 1024.0  // Espera (s) de cada descarte no objetivo media: o fim do
+                                // histograma de esperas, alem do qual o p95 e infinito
+
+// Desvio inicial de cada peso, na escala do ETA (s): um andar, uma fila cheia, uma
+// parada e uma inversao de sentido custam da ordem destes segundos
+static const double desvio_inicial[N_PESOS] = {2.0, 20.0, 5.0, 10.0};
+static const char* nomes_pesos[N_PESOS] = {"distancia", "carga", "paradas", "direcao"};
+
+
+/* === ESTRUTURAS DE DADOS === */
+typedef struct
+{
+    const Predio* predio;
+    PesosDespacho pesos;
+    uint64_t semente;
+    int ok;
+    ResultadoDet resultado;
+} Execucao;
+
+// Execucoes de uma geracao: cada thread retira a proxima livre
+typedef struct
+{
+    Execucao* execucoes;
+    int n;
+    int proxima;
+} LoteExecucoes;
+
+typedef struct
+{
+    double x[N_PESOS];
+    double aptidao;         // Objetivo medio nas replicas (menor e melhor)
+} Candidato;
+
+// Distribuicao da espera de um conjunto de pesos, media das replicas
+typedef struct
+{
+    double media, p50, p95, p99, maxima;
+    double descartadas;
+} Distribuicao;
+
+
+/* === EXECUCAO PARALELA === */
+static void* funcao_execucoes(void* arg)
+{
+    LoteExecucoes* lote = (LoteExecucoes*)arg;
+    eta_isolar_thread();
+    demanda_isolar_thread();
+    zonas_isolar_thread();
+
+    while (TRUE) {
+        int i = __atomic_fetch_add(&lote->proxima, 1, __ATOMIC_RELAXED);
+        if (i >= lote->n)
+            break;
+        Execucao* e = &lote->execucoes[i];
+        deterministico_definir_pesos(&e->pesos);
+        e->ok = deterministico_simular_predio(e->predio, e->semente, &e->resultado);
+    }
+
+    deterministico_finalizar();
+    return NULL;
+}
+
+static int executar_lote(Execucao* execucoes, int n, int n_threads)
+{
+    LoteExecucoes lote = {execucoes, n, 0};
+    if (n_threads > n)
+        n_threads = n;
+    pthread_t threads[n_threads];
+    for (int i = 0; i < n_threads; i++) {
+        if (pthread_create(&threads[i], NULL, funcao_execucoes, &lote) != 0) {
+            printf("Erro: nao foi possivel criar a thread %d do otimizador\n", i);
+            exit(1);
+        }
+    }
+    for (int i = 0; i < n_threads; i++)
+        pthread_join(threads[i], NULL);
+
+    int ok = TRUE;
+    for (int i = 0; i < n; i++)
+        ok = ok && execucoes[i].ok;
+    return ok;
+}
+
+
+/* === CANDIDATOS === */
+static PesosDespacho para_pesos(const double* x)
+{
+    PesosDespacho p = {1, x[0], x[1], x[2], x[3]};
+    return p;
+}
+
+// Normal padrao (Box-Muller)
+static double normal(Aleatorio* rng)
+{
+    double u = aleatorio_uniforme(rng);
+    double v = aleatorio_uniforme(rng);
+    return sqrt(-2.0 * log(1.0 - u)) * cos(2.0 * M_PI * v);
+}
+
+// A espera media so cobre quem embarcou: sem a penalidade, descartar mais chamadas
+// melhoraria o objetivo
+static double objetivo(const ResultadoDet* r, int tipo)
+{
+    if (tipo == OBJETIVO_P95)
+        return r->espera_p95;
+    long long total = r->embarques + r->descartadas;
+    if (total == 0)
+        return 0;
+    return (r->espera_media * r->embarques + ESPERA_DESCARTE * r->descartadas) / total;
+}
+
+static int comparar_candidatos(const void* pa, const void* pb)
+{
+    const Candidato* a = (const Candidato*)pa;
+    const Candidato* b = (const Candidato*)pb;
+    if (a->aptidao != b->aptidao)
+        return a->aptidao < b->aptidao ? -1 : 1;
+    return 0;
+}
+
+// Distribuicao da espera de cada conjunto de pesos em replicas sementes a partir de semente
+static int medir(const Predio* predio, const PesosDespacho* pesos, int n, int replicas, uint64_t semente,
+                 int n_threads, Distribuicao* d)
+{
+    Execucao* execucoes = malloc(n * replicas * sizeof(Execucao));
+    if (execucoes == NULL) {
+        printf("Erro: sem memoria para a validacao\n");
+        return FALSE;
+    }
+    for (int i = 0; i < n * replicas; i++) {
+        execucoes[i].predio = predio;
+        execucoes[i].pesos = pesos[i / replicas];
+        execucoes[i].semente = semente + i % replicas;
+    }
+    int ok = executar_lote(execucoes, n * replicas, n_threads);
+    for (int k = 0; k < n && ok; k++) {
+        memset(&d[k], 0, sizeof(Distribuicao));
+        for (int r = 0; r < replicas; r++) {
+            const ResultadoDet* res = &execucoes[k * replicas + r].resultado;
+            d[k].media += res->espera_media / replicas;
+            d[k].p50 += res->espera_p50 / replicas;
+            d[k].p95 += res->espera_p95 / replicas;
+            d[k].p99 += res->espera_p99 / replicas;
+            d[k].maxima += res->espera_max / replicas;
+            d[k].descartadas += (double)res->descartadas / replicas;
+        }
+    }
+    free(execucoes);
+    return ok;
+}
+
+static void imprimir_distribuicao(const char* nome, const Distribuicao* d)
+{
+    printf("%-8s %9.2f %9.2f %9.2f %9.2f %9.2f %11.1f\n", nome, d->media, d->p50, d->p95, d->p99, d->maxima,
+           d->descartadas);
+}
+
+
+/* === BUSCA === */
+int otimizador_executar(const char* caminho, const ParametrosOtimizador* p)
+{
+    Predio predio;
+    if (!config_carregar(caminho, &predio))
+        return FALSE;
+    if (predio.n_chamadas < 2 || predio.politica.zonas_uniformes < 1) {
+        printf("Erro: %s precisa de pelo menos 2 chamadas e 1 zona\n", caminho);
+        config_liberar(&predio);
+        return FALSE;
+    }
+
+    int n_threads = p->n_nucleos > 0 ? p->n_nucleos : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_threads < 1)
+        n_threads = 1;
+    Candidato* populacao = malloc(p->populacao * sizeof(Candidato));
+    Execucao* execucoes = malloc(p->populacao * p->replicas * sizeof(Execucao));
+    if (populacao == NULL || execucoes == NULL) {
+        printf("Erro: sem memoria para a populacao\n");
+        free(populacao);
+        free(execucoes);
+        config_liberar(&predio);
+        return FALSE;
+    }
+
+    printf("[Otimizador] %s: %s, %d geracoes de %d candidatos (elite %d), %d replicas cada, %d threads\n",
+           caminho, p->objetivo == OBJETIVO_P95 ? "p95 da espera" : "espera media", p->geracoes, p->populacao,
+           p->elite, p->replicas, n_threads);
+
+    // Comeca no menor ETA (pesos extras nulos)
+    double media[N_PESOS] = {0};
+    double desvio[N_PESOS];
+    memcpy(desvio, desvio_inicial, sizeof(desvio));
+    Candidato melhor = {{0}, INFINITY};
+    Aleatorio rng;
+    aleatorio_semear(&rng, p->semente, 0);
+
+    int ok = TRUE;
+    double inicio = relogio_agora();
+    for (int g = 0; g < p->geracoes && ok; g++) {
+        // O primeiro candidato e a propria media. Os pesos sao penalidades: amostras
+        // negativas (premiar carro mais longe ou com mais paradas) viram 0
+        for (int c = 0; c < p->populacao; c++)
+            for (int j = 0; j < N_PESOS; j++) {
+                double x = media[j] + (c > 0 ? desvio[j] * normal(&rng) : 0);
+                populacao[c].x[j] = x > 0 ? x : 0;
+            }
+
+        // Mesmas sementes para todos os candidatos: as diferencas sao dos pesos
+        for (int i = 0; i < p->populacao * p->replicas; i++) {
+            execucoes[i].predio = &predio;
+            execucoes[i].pesos = para_pesos(populacao[i / p->replicas].x);
+            execucoes[i].semente = p->semente + i % p->replicas;
+        }
+        ok = executar_lote(execucoes, p->populacao * p->replicas, n_threads);
+        if (!ok)
+            break;
+        for (int c = 0; c < p->populacao; c++) {
+            populacao[c].aptidao = 0;
+            for (int r = 0; r < p->replicas; r++)
+                populacao[c].aptidao += objetivo(&execucoes[c * p->replicas + r].resultado, p->objetivo) / p->replicas;
+        }
+
+        qsort(populacao, p->populacao, sizeof(Candidato), comparar_candidatos);
+        if (populacao[0].aptidao < melhor.aptidao)
+            melhor = populacao[0];
+
+        // Nova distribuicao: media e desvio da elite, suavizados com os anteriores
+        for (int j = 0; j < N_PESOS; j++) {
+            double soma = 0, soma_quadrados = 0;
+            for (int c = 0; c < p->elite; c++) {
+                soma += populacao[c].x[j];
+                soma_quadrados += populacao[c].x[j] * populacao[c].x[j];
+            }
+            double m = soma / p->elite;
+            double v = soma_quadrados / p->elite - m * m;
+            media[j] = SUAVIZACAO * m + (1 - SUAVIZACAO) * media[j];
+            desvio[j] = SUAVIZACAO * sqrt(v > 0 ? v : 0) + (1 - SUAVIZACAO) * desvio[j];
+            if (desvio[j] < DESVIO_MINIMO * desvio_inicial[j])
+                desvio[j] = DESVIO_MINIMO * desvio_inicial[j];
+        }
+
+        printf("[Otimizador] geracao %2d: melhor %.2fs, melhor ate aqui %.2fs (", g + 1, populacao[0].aptidao,
+               melhor.aptidao);
+        for (int j = 0; j < N_PESOS; j++)
+            printf("%s%s %.3f", j > 0 ? ", " : "", nomes_pesos[j], melhor.x[j]);
+        printf(")\n");
+    }
+
+    // Validacao em sementes que a busca nao viu
+    Distribuicao distribuicoes[2];
+    PesosDespacho comparados[2] = {PESOS_DESPACHO_PADRAO, para_pesos(melhor.x)};
+    if (ok)
+        ok = medir(&predio, comparados, 2, p->replicas, p->semente + p->replicas, n_threads, distribuicoes);
+    double parede = relogio_agora() - inicio;
+
+    if (ok) {
+        printf("\n=== OTIMIZACAO FINALIZADA ===\n");
+        printf("Melhores pesos: --pesos 1,%.3f,%.3f,%.3f,%.3f\n", melhor.x[0], melhor.x[1], melhor.x[2], melhor.x[3]);
+        printf("Espera ate o embarque em %d sementes novas (s, media das replicas):\n", p->replicas);
+        printf("%-8s %9s %9s %9s %9s %9s %11s\n", "pesos", "media", "p50", "p95", "p99", "maxima", "descartes");
+        imprimir_distribuicao("padrao", &distribuicoes[0]);
+        imprimir_distribuicao("melhores", &distribuicoes[1]);
+        printf("Tempo de parede: %.2fs (%d simulacoes)\n", parede,
+               (p->geracoes * p->populacao + 2) * p->replicas);
+    }
+
+    free(populacao);
+    free(execucoes);
+    config_liberar(&predio);
+    return ok;
+}
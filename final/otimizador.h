@@ -0,0 +1,32 @@
+#ifndef OTIMIZADOR_H
+#define OTIMIZADOR_H
+
+#include <stdint.h>
+
+/* === OTIMIZADOR DOS PESOS DE DESPACHO === */
+// Busca evolutiva (entropia cruzada com covariancia diagonal) dos pesos do despacho por
+// custo (PesosDespacho em deterministico.h). O peso do ETA fica em 1 e os outros quatro
+// sao buscados. A cada geracao, a media atual e populacao-1 amostras normais em torno
+// dela sao avaliadas por replicas do motor deterministico com as mesmas sementes, em
+// paralelo. A media e o desvio de cada peso passam a ser os da elite (as melhores).
+//
+// No fim, os melhores pesos e os padrao (menor ETA) sao comparados em sementes novas,
+// com a distribuicao da espera (media, p50, p95, p99, maxima).
+#define OBJETIVO_MEDIA 0        // Espera media ate o embarque (descartes contam 1024 s)
+#define OBJETIVO_P95 1          // p95 da espera (descartes contam como infinito)
+
+typedef struct
+{
+    int objetivo;
+    int geracoes;
+    int populacao;
+    int elite;
+    int replicas;               // Sementes por candidato
+    int n_nucleos;              // 0: todos os nucleos
+    uint64_t semente;
+} ParametrosOtimizador;
+
+// Retorna FALSE se o predio nao carregar ou uma simulacao falhar
+int otimizador_executar(const char* caminho, const ParametrosOtimizador* p);
+
+#endif
@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include "painel.h"
+#include "metricas.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define JANELA_LATENCIA 10      // Segundos considerados nas latencias recentes
+#define LINHAS_FIXAS 8          // Cabecalho, titulos e latencias
+#define MAX_LINHAS_ELEVADORES 8
+#define LARGURA_ELEVADOR 3
+
+
+/* === VARIAVEIS GLOBAIS === */
+static int fd_terminal = -1;    // Terminal original; a saida padrao vai para /dev/null
+static int andares, n_elevadores;
+static double periodo;
+static int painel_ativo = FALSE; // Lido sem trava pela thread do painel (atomicos)
+static pthread_t thread_painel;
+
+// Retratos de segundo em segundo para as taxas e latencias da janela recente
+static RetratoMetricas historico[JANELA_LATENCIA + 1];
+static int historico_inicio = 0, historico_contador = 0;
+
+
+/* === TEXTO DO QUADRO === */
+typedef struct
+{
+    char* dados;
+    size_t n;
+    size_t cap;
+} Quadro;
+
+static void escrever(Quadro* q, const char* formato, ...)
+{
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(NULL, 0, formato, args);
+    va_end(args);
+    if (n < 0)
+        return;
+    if (q->n + n + 1 > q->cap) {
+        size_t cap = q->cap == 0 ? 4096 : q->cap;
+        while (q->n + n + 1 > cap)
+            cap *= 2;
+        char* dados = realloc(q->dados, cap);
+        if (dados == NULL)
+            return;
+        q->dados = dados;
+        q->cap = cap;
+    }
+    va_start(args, formato);
+    vsnprintf(q->dados + q->n, q->cap - q->n, formato, args);
+    va_end(args);
+    q->n += n;
+}
+
+// Fim de linha: apaga o resto da linha anterior do terminal
+static void nova_linha(Quadro* q)
+{
+    escrever(q, "\x1b[K\n");
+}
+
+
+/* === DESENHO === */
+static void desenhar_latencias(Quadro* q, const char* nome, const unsigned long long* atual,
+                               const unsigned long long* antigo)
+{
+    unsigned long long recente[METRICAS_BALDES];
+    unsigned long long total = 0;
+    for (int k = 0; k < METRICAS_BALDES; k++) {
+        recente[k] = atual[k] - antigo[k];
+        total += recente[k];
+    }
+    escrever(q, " %-8s p50 %5.1fs  p90 %5.1fs  p99 %5.1fs  (%llu)", nome, metricas_percentil(recente, 0.5),
+             metricas_percentil(recente, 0.9), metricas_percentil(recente, 0.99), total);
+    nova_linha(q);
+}
+
+static void desenhar(Quadro* q, int linhas, int colunas)
+{
+    RetratoMetricas r;
+    metricas_retrato(&r);
+    if (historico_contador == 0 || r.tempo - historico[(historico_inicio + historico_contador - 1)
+                                                       % (JANELA_LATENCIA + 1)].tempo >= 1.0) {
+        if (historico_contador == JANELA_LATENCIA + 1) {
+            historico_inicio = (historico_inicio + 1) % (JANELA_LATENCIA + 1);
+            historico_contador--;
+        }
+        historico[(historico_inicio + historico_contador) % (JANELA_LATENCIA + 1)] = r;
+        historico_contador++;
+    }
+    const RetratoMetricas* antigo = &historico[historico_inicio];
+    double intervalo = r.tempo - antigo->tempo;
+
+    RetratoElevador elevs[n_elevadores];
+    for (int i = 0; i < n_elevadores; i++)
+        metricas_retrato_elevador(i, &elevs[i]);
+
+    // Cabecalho
+    escrever(q, "\x1b[H\x1b[1mSimulacao t=%.1fs\x1b[0m  geradas %llu  despachadas %llu  descartadas %llu"
+                "  backlog %d  %.1f chamadas/s",
+             r.tempo, r.geradas, r.despachadas, r.descartadas, r.backlog,
+             intervalo > 0 ? (r.geradas - antigo->geradas) / intervalo : 0.0);
+    nova_linha(q);
+    nova_linha(q);
+
+    // Pocos: com mais andares que linhas, cada linha agrupa varios andares
+    int linhas_elevs = n_elevadores < MAX_LINHAS_ELEVADORES ? n_elevadores : MAX_LINHAS_ELEVADORES;
+    int linhas_pocos = linhas - LINHAS_FIXAS - linhas_elevs;
+    if (linhas_pocos < 2)
+        linhas_pocos = 2;
+    int por_linha = (andares + linhas_pocos - 1) / linhas_pocos;
+    int visiveis = (colunas - 24) / LARGURA_ELEVADOR;
+    if (visiveis > n_elevadores)
+        visiveis = n_elevadores;
+    if (visiveis < 1)
+        visiveis = 1;
+
+    escrever(q, " andar ");
+    for (int i = 0; i < visiveis; i++)
+        escrever(q, "%*s%-*d", 1, "E", LARGURA_ELEVADOR - 1, i);
+    escrever(q, "%s aguardando", visiveis < n_elevadores ? "..." : "");
+    nova_linha(q);
+
+    for (int topo = andares - 1; topo >= 0; topo -= por_linha) {
+        int base = topo - por_linha + 1 < 0 ? 0 : topo - por_linha + 1;
+        if (por_linha == 1)
+            escrever(q, " %5d ", topo);
+        else
+            escrever(q, " %2d-%-2d ", base, topo);
+
+        for (int i = 0; i < visiveis; i++) {
+            RetratoElevador* e = &elevs[i];
+            if (e->andar < base || e->andar > topo)
+                escrever(q, " . ");
+            else if (e->destino > e->andar)
+                escrever(q, "\x1b[32m[^]\x1b[0m");
+            else if (e->destino < e->andar)
+                escrever(q, "\x1b[32m[v]\x1b[0m");
+            else if (e->ocupado)
+                escrever(q, "\x1b[33m[*]\x1b[0m");
+            else
+                escrever(q, "[ ]");
+        }
+
+        int esperando = 0;
+        for (int a = base; a <= topo; a++)
+            esperando += metricas_aguardando(a);
+        escrever(q, "%s ", visiveis < n_elevadores ? "   " : "");
+        for (int k = 0; k < esperando && k < 20; k++)
+            escrever(q, "*");
+        if (esperando > 0)
+            escrever(q, " %d", esperando);
+        nova_linha(q);
+    }
+    nova_linha(q);
+
+    // Estado de cada elevador
+    for (int i = 0; i < linhas_elevs; i++) {
+        RetratoElevador* e = &elevs[i];
+        if (e->destino != e->andar)
+            escrever(q, " E%-3d andar %3d -> %-3d", i, e->andar, e->destino);
+        else
+            escrever(q, " E%-3d andar %3d       ", i, e->andar);
+        escrever(q, "  fila %d  atendidas %llu", e->fila, e->atendidas);
+        nova_linha(q);
+    }
+    if (linhas_elevs < n_elevadores) {
+        escrever(q, " ... mais %d elevadores", n_elevadores - linhas_elevs);
+        nova_linha(q);
+    }
+    nova_linha(q);
+
+    // Latencias da janela recente
+    escrever(q, " \x1b[1mlatencias (ultimos %.0fs)\x1b[0m", intervalo);
+    nova_linha(q);
+    desenhar_latencias(q, "espera", r.espera, antigo->espera);
+    desenhar_latencias(q, "viagem", r.viagem, antigo->viagem);
+    escrever(q, "\x1b[J");
+}
+
+static void* funcao_painel(void* arg)
+{
+    Quadro q = {NULL, 0, 0};
+    while (__atomic_load_n(&painel_ativo, __ATOMIC_ACQUIRE)) {
+        struct winsize w;
+        int linhas = 40, colunas = 100;
+        if (ioctl(fd_terminal, TIOCGWINSZ, &w) == 0 && w.ws_row > 0) {
+            linhas = w.ws_row;
+            colunas = w.ws_col;
+        }
+
+        // Um unico write por quadro evita cintilacao
+        q.n = 0;
+        desenhar(&q, linhas, colunas);
+        if (q.n > 0 && write(fd_terminal, q.dados, q.n) < 0)
+            break;
+        // Quadros em tempo real, qualquer que seja a escala do relogio da simulacao
+        usleep((useconds_t)(periodo * 1e6));
+    }
+    free(q.dados);
+    return 0;
+}
+
+
+/* === CICLO DE VIDA === */
+int painel_iniciar(int n_andares, int n_elev, double quadros_por_segundo)
+{
+    if (quadros_por_segundo <= 0) {
+        printf("Erro: taxa de quadros do painel deve ser positiva\n");
+        return FALSE;
+    }
+
+    // O log da simulacao rolaria por cima do painel: vai para /dev/null
+    fflush(stdout);
+    fd_terminal = dup(STDOUT_FILENO);
+    int nulo = open("/dev/null", O_WRONLY);
+    if (fd_terminal < 0 || nulo < 0) {
+        printf("Erro: nao foi possivel preparar o terminal do painel\n");
+        return FALSE;
+    }
+    dup2(nulo, STDOUT_FILENO);
+    close(nulo);
+
+    andares = n_andares;
+    n_elevadores = n_elev;
+    periodo = 1.0 / quadros_por_segundo;
+
+    // Tela alternativa e cursor oculto
+    const char* abrir = "\x1b[?1049h\x1b[?25l\x1b[2J";
+    if (write(fd_terminal, abrir, strlen(abrir)) < 0)
+        return FALSE;
+
+    __atomic_store_n(&painel_ativo, TRUE, __ATOMIC_RELEASE);
+    pthread_create(&thread_painel, NULL, funcao_painel, NULL);
+    return TRUE;
+}
+
+void painel_finalizar(void)
+{
+    if (!__atomic_load_n(&painel_ativo, __ATOMIC_ACQUIRE))
+        return;
+    __atomic_store_n(&painel_ativo, FALSE, __ATOMIC_RELEASE);
+    pthread_join(thread_painel, NULL);
+
+    const char* fechar = "\x1b[?25h\x1b[?1049l";
+    if (write(fd_terminal, fechar, strlen(fechar)) < 0)
+        perror("[Painel] terminal");
+    fflush(stdout);
+    dup2(fd_terminal, STDOUT_FILENO);
+    close(fd_terminal);
+    fd_terminal = -1;
+}
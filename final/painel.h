@@ -0,0 +1,13 @@
+#ifndef PAINEL_H
+#define PAINEL_H
+
+/* === PAINEL NO TERMINAL (sequencias ANSI, sem ncurses) === */
+// Thread propria que redesenha, a cada quadro, o diagrama dos pocos (andares x elevadores),
+// os passageiros aguardando por andar e as latencias recentes, a partir de um retrato das
+// metricas (atomicos relaxados). O log da simulacao e descartado enquanto o painel esta ativo.
+int painel_iniciar(int n_andares, int n_elevadores, double quadros_por_segundo);
+
+// Encerra a thread, restaura o terminal e a saida padrao
+void painel_finalizar(void);
+
+#endif
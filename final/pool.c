@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pool.h"
+
+#define TRUE 1
+#define FALSE 0
+
+
+/* === CICLO DE VIDA === */
+int pool_iniciar(Pool* p, size_t tam_item, int capacidade)
+{
+    // Cada registro livre guarda o ponteiro para o proximo da lista
+    if (tam_item < sizeof(void*))
+        tam_item = sizeof(void*);
+    tam_item = (tam_item + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+
+    p->memoria = malloc(tam_item * (size_t)capacidade);
+    if (p->memoria == NULL && capacidade > 0) {
+        printf("Erro: sem memoria para o pool (%d registros de %zu bytes)\n", capacidade, tam_item);
+        p->capacidade = 0;
+        return FALSE;
+    }
+    p->tam_item = tam_item;
+    p->capacidade = capacidade;
+    pool_reiniciar(p);
+    return TRUE;
+}
+
+int pool_preparar(Pool* p, size_t tam_item, int capacidade)
+{
+    if (p->memoria != NULL && p->tam_item >= tam_item && p->capacidade >= capacidade) {
+        pool_reiniciar(p);
+        return TRUE;
+    }
+    pool_finalizar(p);
+    return pool_iniciar(p, tam_item, capacidade);
+}
+
+void pool_finalizar(Pool* p)
+{
+    free(p->memoria);
+    p->memoria = NULL;
+    p->capacidade = 0;
+    pool_reiniciar(p);
+}
+
+void pool_reiniciar(Pool* p)
+{
+    p->avanco = 0;
+    p->em_uso = 0;
+    p->pico = 0;
+    p->livres = NULL;
+}
@@ -0,0 +1,59 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+/* === POOL DE REGISTROS DE TAMANHO FIXO === */
+// Um unico bloco (slab) com capacidade fixa, dimensionado por simulacao.
+// Registros devolvidos vao para uma lista livre e sao reaproveitados primeiro;
+// os demais saem do bloco em ordem (ponteiro de avanco). Sem malloc/free no
+// caminho quente e sem fragmentar o heap entre execucoes seguidas.
+// Nao e thread-safe: cada pool pertence a uma unica thread.
+typedef struct
+{
+    char* memoria;
+    size_t tam_item;
+    int capacidade;
+    int avanco;         // Registros ja entregues a partir do bloco
+    int em_uso;
+    int pico;           // Maior em_uso desde o ultimo reinicio
+    void* livres;       // Lista livre (o proprio registro guarda o proximo)
+} Pool;
+
+// Reserva o bloco para capacidade registros de tam_item bytes. Retorna FALSE sem memoria.
+int pool_iniciar(Pool* p, size_t tam_item, int capacidade);
+
+// Garante o bloco para pelo menos capacidade registros de tam_item bytes,
+// reaproveitando o atual quando ele basta, e o deixa vazio
+int pool_preparar(Pool* p, size_t tam_item, int capacidade);
+
+void pool_finalizar(Pool* p);
+
+// Descarta todos os registros de uma vez, em O(1)
+void pool_reiniciar(Pool* p);
+
+// Retorna NULL quando a capacidade se esgota
+static inline void* pool_alocar(Pool* p)
+{
+    void* item;
+    if (p->livres != NULL) {
+        item = p->livres;
+        p->livres = *(void**)item;
+    } else if (p->avanco < p->capacidade) {
+        item = p->memoria + (size_t)p->avanco++ * p->tam_item;
+    } else {
+        return NULL;
+    }
+    if (++p->em_uso > p->pico)
+        p->pico = p->em_uso;
+    return item;
+}
+
+static inline void pool_devolver(Pool* p, void* item)
+{
+    *(void**)item = p->livres;
+    p->livres = item;
+    p->em_uso--;
+}
+
+#endif
@@ -0,0 +1,234 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "portfolio.h"
+#include "config.h"
+#include "deterministico.h"
+#include "relogio.h"
+#include "eta.h"
+#include "demanda.h"
+#include "zonas.h"
+
+#define TRUE 1
+#define FALSE 0
+#define TAM_CAMINHO 1024
+
+
+/* === ESTRUTURAS DE DADOS === */
+typedef struct
+{
+    char caminho[TAM_CAMINHO];
+    int linha;              // Linha na lista (relatorio)
+    uint64_t semente;
+    int ok;
+    int nucleo;             // CPU em que foi simulado
+    int n_andares;
+    int n_elevadores;
+    double duracao;         // Tempo de parede da simulacao (s)
+    ResultadoDet resultado;
+} PredioPortfolio;
+
+// Lista compartilhada: cada thread retira o proximo indice livre
+typedef struct
+{
+    PredioPortfolio* predios;
+    int n;
+    int proximo;
+} FilaPredios;
+
+typedef struct
+{
+    pthread_t thread;
+    FilaPredios* fila;
+} Trabalhador;
+
+
+/* === LEITURA DA LISTA === */
+// Retorna o numero de predios lidos, ou -1 em caso de erro
+static int ler_lista(const char* lista, uint64_t semente_padrao, PredioPortfolio* predios)
+{
+    FILE* f = fopen(lista, "r");
+    if (f == NULL) {
+        printf("Erro: nao foi possivel abrir %s\n", lista);
+        return -1;
+    }
+
+    // Caminhos relativos partem do diretorio da lista
+    const char* barra = strrchr(lista, '/');
+    int tam_diretorio = barra != NULL ? (int)(barra - lista) + 1 : 0;
+
+    char buf[TAM_CAMINHO];
+    int n = 0;
+    int linha = 0;
+    while (fgets(buf, sizeof(buf), f) != NULL) {
+        linha++;
+        buf[strcspn(buf, "#\r\n")] = '\0';
+        char arquivo[TAM_CAMINHO];
+        unsigned long long semente = semente_padrao;
+        int campos = sscanf(buf, "%1023s %llu", arquivo, &semente);
+        if (campos < 1)
+            continue;
+        if (n == MAX_PREDIOS) {
+            printf("%s:%d: mais de %d predios na lista\n", lista, linha, MAX_PREDIOS);
+            fclose(f);
+            return -1;
+        }
+
+        PredioPortfolio* p = &predios[n++];
+        memset(p, 0, sizeof(*p));
+        int tam = arquivo[0] == '/' ? snprintf(p->caminho, sizeof(p->caminho), "%s", arquivo)
+                                    : snprintf(p->caminho, sizeof(p->caminho), "%.*s%s", tam_diretorio, lista, arquivo);
+        if (tam >= (int)sizeof(p->caminho)) {
+            printf("%s:%d: caminho longo demais\n", lista, linha);
+            fclose(f);
+            return -1;
+        }
+        p->linha = linha;
+        p->semente = semente;
+        p->nucleo = -1;
+    }
+    fclose(f);
+
+    if (n == 0)
+        printf("Erro: nenhum predio em %s\n", lista);
+    return n > 0 ? n : -1;
+}
+
+
+/* === SIMULACAO DE UM PREDIO === */
+static void simular_predio(PredioPortfolio* pp)
+{
+    pp->nucleo = sched_getcpu();
+
+    // Carregado aqui: tabelas do predio alocadas (e tocadas) no no do nucleo
+    Predio predio;
+    if (!config_carregar(pp->caminho, &predio))
+        return;
+    pp->n_andares = predio.n_andares;
+    pp->n_elevadores = predio.n_elevadores;
+    if (predio.n_chamadas < 2 || predio.politica.zonas_uniformes < 1) {
+        printf("Erro: %s precisa de pelo menos 2 chamadas e 1 zona\n", pp->caminho);
+        config_liberar(&predio);
+        return;
+    }
+
+    double inicio = relogio_agora();
+    pp->ok = deterministico_simular_predio(&predio, pp->semente, &pp->resultado);
+    pp->duracao = relogio_agora() - inicio;
+
+    config_liberar(&predio);
+}
+
+static void* funcao_trabalhador(void* arg)
+{
+    Trabalhador* t = (Trabalhador*)arg;
+    eta_isolar_thread();
+    demanda_isolar_thread();
+    zonas_isolar_thread();
+
+    while (TRUE) {
+        int i = __atomic_fetch_add(&t->fila->proximo, 1, __ATOMIC_RELAXED);
+        if (i >= t->fila->n)
+            break;
+        simular_predio(&t->fila->predios[i]);
+    }
+
+    // Roda e pools da thread, reaproveitados entre os predios dela
+    deterministico_finalizar();
+    return NULL;
+}
+
+
+/* === EXECUCAO === */
+int portfolio_executar(const char* lista, int n_nucleos, uint64_t semente_padrao)
+{
+    PredioPortfolio* predios = malloc(MAX_PREDIOS * sizeof(PredioPortfolio));
+    if (predios == NULL) {
+        printf("Erro: sem memoria para o portfolio\n");
+        return FALSE;
+    }
+    int n = ler_lista(lista, semente_padrao, predios);
+    if (n < 0) {
+        free(predios);
+        return FALSE;
+    }
+
+    // Nucleos permitidos ao processo (taskset/cgroup), em ordem
+    cpu_set_t permitidos;
+    int nucleos[CPU_SETSIZE];
+    int n_permitidos = 0;
+    if (sched_getaffinity(0, sizeof(permitidos), &permitidos) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; c++)
+            if (CPU_ISSET(c, &permitidos))
+                nucleos[n_permitidos++] = c;
+    }
+    int n_threads = n_nucleos > 0 ? n_nucleos : n_permitidos;
+    if (n_threads < 1)
+        n_threads = 1;
+    if (n_threads > n)
+        n_threads = n;
+
+    printf("[Portfolio] %d predios em %d threads (%d nucleos disponiveis)\n", n, n_threads, n_permitidos);
+    FilaPredios fila = {predios, n, 0};
+    Trabalhador trabalhadores[n_threads];
+    double inicio = relogio_agora();
+    for (int i = 0; i < n_threads; i++) {
+        // Fixada antes de comecar: a primeira alocacao da thread ja e no no certo
+        pthread_attr_t atributos;
+        pthread_attr_init(&atributos);
+        if (n_permitidos > 0) {
+            cpu_set_t nucleo;
+            CPU_ZERO(&nucleo);
+            CPU_SET(nucleos[i % n_permitidos], &nucleo);
+            pthread_attr_setaffinity_np(&atributos, sizeof(nucleo), &nucleo);
+        }
+        trabalhadores[i].fila = &fila;
+        if (pthread_create(&trabalhadores[i].thread, &atributos, funcao_trabalhador, &trabalhadores[i]) != 0) {
+            printf("Erro: nao foi possivel criar a thread %d do portfolio\n", i);
+            exit(1);
+        }
+        pthread_attr_destroy(&atributos);
+    }
+    for (int i = 0; i < n_threads; i++)
+        pthread_join(trabalhadores[i].thread, NULL);
+    double parede = relogio_agora() - inicio;
+
+    // Relatorio agregado
+    printf("\n=== PORTFOLIO FINALIZADO ===\n");
+    printf("%-28s %8s %7s %6s %10s %10s %10s %11s %9s %6s  %s\n", "predio", "semente", "andares",
+           "elevs", "geradas", "concluidas", "descartes", "simulado(s)", "parede(s)", "nucleo", "digest");
+    int ok = TRUE;
+    long long geradas = 0, concluidas = 0, descartadas = 0;
+    unsigned long long eventos = 0;
+    double soma_duracoes = 0;
+    for (int i = 0; i < n; i++) {
+        const PredioPortfolio* p = &predios[i];
+        const char* nome = strrchr(p->caminho, '/') != NULL ? strrchr(p->caminho, '/') + 1 : p->caminho;
+        if (!p->ok) {
+            printf("%-28s %8llu  falhou (linha %d da lista)\n", nome, (unsigned long long)p->semente, p->linha);
+            ok = FALSE;
+            continue;
+        }
+        const ResultadoDet* r = &p->resultado;
+        printf("%-28s %8llu %7d %6d %10d %10d %10d %11.1f %9.2f %6d  %016llx\n", nome,
+               (unsigned long long)p->semente, p->n_andares, p->n_elevadores, r->geradas, r->concluidas,
+               r->descartadas, r->tempo_simulado, p->duracao, p->nucleo, (unsigned long long)r->digest);
+        geradas += r->geradas;
+        concluidas += r->concluidas;
+        descartadas += r->descartadas;
+        eventos += r->registros;
+        soma_duracoes += p->duracao;
+    }
+
+    printf("Total: %lld chamadas geradas, %lld concluidas, %lld descartadas (%llu eventos)\n",
+           geradas, concluidas, descartadas, eventos);
+    printf("Tempo de parede: %.2fs (%.0f chamadas/s agregadas)\n", parede, parede > 0 ? geradas / parede : 0.0);
+    // Soma dos tempos por predio sobre o tempo de parede: ideal = numero de threads
+    printf("Paralelismo efetivo: %.2f de %d threads\n", parede > 0 ? soma_duracoes / parede : 0.0, n_threads);
+
+    free(predios);
+    return ok;
+}
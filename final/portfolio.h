@@ -0,0 +1,21 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <stdint.h>
+
+/* === PORTFOLIO: VARIOS PREDIOS NUM PROCESSO === */
+// Lista de predios: uma linha "<arquivo.ini> [semente]" por predio, com caminhos relativos
+// ao diretorio da lista; '#' inicia comentario. Sem semente, usa semente_padrao.
+//
+// Cada predio e uma simulacao deterministica isolada (motor, ETA, demanda e zonas com
+// estado da propria thread), com o mesmo digest de --config <arquivo.ini> --deterministico.
+// Uma thread por nucleo, fixada nele, retira predios da lista ate esgota-la. O predio
+// e carregado e simulado pela thread que o executa: pela politica de primeiro toque,
+// a memoria dele fica no no NUMA do nucleo.
+#define MAX_PREDIOS 1024
+
+// n_nucleos <= 0 usa todos os nucleos permitidos ao processo.
+// Retorna TRUE se todos os predios carregaram e simularam ate o fim.
+int portfolio_executar(const char* lista, int n_nucleos, uint64_t semente_padrao);
+
+#endif
@@ -0,0 +1,126 @@
+#include <time.h>
+#include <sched.h>
+#include <errno.h>
+#include "relogio.h"
+
+#define ATRASO_TOLERADO_NS 1000000LL    // Ate 1 ms (real) depois do prazo nao conta como atraso
+
+/* === RELOGIO DA SIMULACAO === */
+// Epoca da simulacao (CLOCK_MONOTONIC, imune a ajustes do relogio do sistema)
+static struct timespec epoca;
+
+// Segundos reais por segundo da simulacao (1 = tempo real; 0 = sem esperas, apenas cede
+// o processador, e o relogio corre em tempo real)
+static double escala = 1.0;
+
+// Contadores das esperas com prazo, atualizados por todas as threads
+static long esperas = 0;
+static long vencidas = 0;
+static long atrasadas = 0;
+static long long atraso_max_ns = 0;
+
+static long long para_ns(const struct timespec* t)
+{
+    return t->tv_sec * 1000000000LL + t->tv_nsec;
+}
+
+static void de_ns(long long ns, struct timespec* t)
+{
+    t->tv_sec = ns / 1000000000LL;
+    t->tv_nsec = ns % 1000000000LL;
+    if (t->tv_nsec < 0) {
+        t->tv_nsec += 1000000000L;
+        t->tv_sec--;
+    }
+}
+
+// Nanossegundos reais do instante da simulacao a partir da epoca
+static long long escalar_ns(double instante)
+{
+    return (long long)(instante * (escala > 0 ? escala : 1.0) * 1e9);
+}
+
+void relogio_iniciar(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &epoca);
+}
+
+void relogio_iniciar_em(double t)
+{
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    de_ns(para_ns(&agora) - escalar_ns(t), &epoca);
+}
+
+long long relogio_epoca_ns(void)
+{
+    return para_ns(&epoca);
+}
+
+double relogio_agora(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    double real = (double)(t.tv_sec - epoca.tv_sec) + (t.tv_nsec - epoca.tv_nsec) / 1e9;
+    return escala > 0 ? real / escala : real;
+}
+
+double relogio_real(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+void relogio_definir_escala(double fator)
+{
+    escala = fator;
+}
+
+double relogio_escala(void)
+{
+    return escala;
+}
+
+void relogio_prazo(double instante, struct timespec* prazo)
+{
+    de_ns(para_ns(&epoca) + escalar_ns(instante), prazo);
+}
+
+void relogio_esperar_ate(double instante)
+{
+    if (escala == 0) {
+        sched_yield();
+        return;
+    }
+    struct timespec prazo, agora;
+    relogio_prazo(instante, &prazo);
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    __atomic_fetch_add(&esperas, 1, __ATOMIC_RELAXED);
+    if (para_ns(&agora) >= para_ns(&prazo)) {
+        if (para_ns(&agora) - para_ns(&prazo) > ATRASO_TOLERADO_NS)
+            __atomic_fetch_add(&vencidas, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &prazo, NULL) == EINTR)
+        ;
+
+    // Atraso do despertar em relacao ao prazo
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    long long atraso = para_ns(&agora) - para_ns(&prazo);
+    if (atraso > ATRASO_TOLERADO_NS) {
+        __atomic_fetch_add(&atrasadas, 1, __ATOMIC_RELAXED);
+        long long max = __atomic_load_n(&atraso_max_ns, __ATOMIC_RELAXED);
+        while (atraso > max && !__atomic_compare_exchange_n(&atraso_max_ns, &max, atraso, 1,
+                                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            ;
+    }
+}
+
+void relogio_atrasos(long* n_esperas, long* n_vencidas, long* n_atrasadas, double* atraso_max)
+{
+    *n_esperas = __atomic_load_n(&esperas, __ATOMIC_RELAXED);
+    *n_vencidas = __atomic_load_n(&vencidas, __ATOMIC_RELAXED);
+    *n_atrasadas = __atomic_load_n(&atrasadas, __ATOMIC_RELAXED);
+    *atraso_max = __atomic_load_n(&atraso_max_ns, __ATOMIC_RELAXED) / 1e9;
+}
@@ -0,0 +1,41 @@
+#ifndef RELOGIO_H
+#define RELOGIO_H
+
+#include <time.h>
+
+// Marca o instante zero da simulacao (epoca)
+void relogio_iniciar(void);
+
+// Marca a epoca de forma que o relogio continue a partir de t segundos (restauracao)
+void relogio_iniciar_em(double t);
+
+// Epoca em nanossegundos de CLOCK_MONOTONIC (para processos externos calcularem o relogio)
+long long relogio_epoca_ns(void);
+
+// Segundos da simulacao decorridos desde a epoca (o tempo real dividido pela escala)
+double relogio_agora(void);
+
+// Segundos de CLOCK_MONOTONIC sem a escala, para medir duracoes reais (esperas por
+// travas, vazao do servico) que nao devem encolher com --escala-tempo
+double relogio_real(void);
+
+// Segundos reais por segundo da simulacao, aplicado a todas as esperas (1: tempo real;
+// 0,1: dez vezes mais rapido; 0: sem esperas, apenas cede o processador). Definir antes
+// de relogio_iniciar e de criar as threads
+void relogio_definir_escala(double fator);
+double relogio_escala(void);
+
+// Instante absoluto (CLOCK_MONOTONIC, com a escala aplicada) do instante da simulacao,
+// para esperas com prazo (pthread_cond_timedwait)
+void relogio_prazo(double instante, struct timespec* prazo);
+
+// Suspende a thread chamadora ate o instante da simulacao, com prazo absoluto
+// (clock_nanosleep): esperas encadeadas nao acumulam deriva
+void relogio_esperar_ate(double instante);
+
+// Contadores de relogio_esperar_ate: esperas, prazos vencidos ha mais de 1 ms (real) ao
+// pedir a espera (a thread chegou atrasada), despertares mais de 1 ms depois do prazo e o
+// maior desses atrasos (s reais)
+void relogio_atrasos(long* esperas, long* vencidas, long* atrasadas, double* atraso_max);
+
+#endif
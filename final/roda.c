@@ -0,0 +1,335 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "roda.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define MASCARA (RODA_ENCAIXES - 1)
+#define ALCANCE ((int64_t)1 << (RODA_BITS * RODA_NIVEIS))
+
+
+/* === HEAP MINIMO DE NOS === */
+int heap_iniciar(HeapNos* h, int capacidade, FuncaoAntes antes)
+{
+    h->nos = malloc((capacidade > 0 ? capacidade : 1) * sizeof(NoRoda*));
+    h->n = 0;
+    h->capacidade = h->nos != NULL ? (capacidade > 0 ? capacidade : 1) : 0;
+    h->antes = antes;
+    if (h->nos == NULL) {
+        printf("Erro: sem memoria para o heap de eventos\n");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void heap_finalizar(HeapNos* h)
+{
+    free(h->nos);
+    h->nos = NULL;
+    h->n = 0;
+    h->capacidade = 0;
+}
+
+static void heap_colocar(HeapNos* h, int i, NoRoda* no)
+{
+    h->nos[i] = no;
+    no->indice = i;
+}
+
+static void heap_subir(HeapNos* h, int i, NoRoda* no)
+{
+    while (i > 0 && h->antes(no, h->nos[(i - 1) / 2])) {
+        heap_colocar(h, i, h->nos[(i - 1) / 2]);
+        i = (i - 1) / 2;
+    }
+    heap_colocar(h, i, no);
+}
+
+static void heap_descer(HeapNos* h, int i, NoRoda* no)
+{
+    while (TRUE) {
+        int filho = 2 * i + 1;
+        if (filho >= h->n)
+            break;
+        if (filho + 1 < h->n && h->antes(h->nos[filho + 1], h->nos[filho]))
+            filho++;
+        if (!h->antes(h->nos[filho], no))
+            break;
+        heap_colocar(h, i, h->nos[filho]);
+        i = filho;
+    }
+    heap_colocar(h, i, no);
+}
+
+int heap_inserir(HeapNos* h, NoRoda* no)
+{
+    if (h->n == h->capacidade) {
+        int capacidade = 2 * h->capacidade;
+        NoRoda** nos = realloc(h->nos, capacidade * sizeof(NoRoda*));
+        if (nos == NULL) {
+            printf("Erro: sem memoria para o heap de eventos\n");
+            return FALSE;
+        }
+        h->nos = nos;
+        h->capacidade = capacidade;
+    }
+    no->local = RODA_HEAP;
+    heap_subir(h, h->n++, no);
+    return TRUE;
+}
+
+NoRoda* heap_retirar(HeapNos* h)
+{
+    if (h->n == 0)
+        return NULL;
+    NoRoda* topo = h->nos[0];
+    NoRoda* ultimo = h->nos[--h->n];
+    if (h->n > 0)
+        heap_descer(h, 0, ultimo);
+    topo->local = RODA_FORA;
+    return topo;
+}
+
+void heap_remover(HeapNos* h, NoRoda* no)
+{
+    int i = no->indice;
+    NoRoda* ultimo = h->nos[--h->n];
+    no->local = RODA_FORA;
+    if (ultimo == no)
+        return;
+    // O ultimo ocupa a vaga e sobe ou desce conforme a ordem
+    if (i > 0 && h->antes(ultimo, h->nos[(i - 1) / 2]))
+        heap_subir(h, i, ultimo);
+    else
+        heap_descer(h, i, ultimo);
+}
+
+
+/* === ENCAIXES === */
+// Bit de ocupacao limpo: a cabeca do encaixe e lixo e nao precisa ser zerada no reinicio
+static void encaixe_inserir(Roda* r, int nivel, int indice, NoRoda* no)
+{
+    uint64_t* palavra = &r->ocupados[nivel][indice / 64];
+    uint64_t bit = (uint64_t)1 << (indice % 64);
+    no->anterior = NULL;
+    no->proximo = (*palavra & bit) ? r->encaixes[nivel][indice] : NULL;
+    if (no->proximo != NULL)
+        no->proximo->anterior = no;
+    r->encaixes[nivel][indice] = no;
+    *palavra |= bit;
+    no->local = nivel;
+    no->indice = indice;
+    r->n_roda++;
+}
+
+static void encaixe_remover(Roda* r, NoRoda* no)
+{
+    if (no->anterior != NULL)
+        no->anterior->proximo = no->proximo;
+    else
+        r->encaixes[no->local][no->indice] = no->proximo;
+    if (no->proximo != NULL)
+        no->proximo->anterior = no->anterior;
+    if (r->encaixes[no->local][no->indice] == NULL)
+        r->ocupados[no->local][no->indice / 64] &= ~((uint64_t)1 << (no->indice % 64));
+    r->n_roda--;
+}
+
+// Primeiro encaixe ocupado do nivel com indice >= inicio, ou -1
+static int proximo_ocupado(const Roda* r, int nivel, int inicio)
+{
+    for (int w = inicio / 64; w < RODA_ENCAIXES / 64; w++) {
+        uint64_t palavra = r->ocupados[nivel][w];
+        if (w == inicio / 64)
+            palavra &= ~(uint64_t)0 << (inicio % 64);
+        if (palavra != 0)
+            return w * 64 + __builtin_ctzll(palavra);
+    }
+    return -1;
+}
+
+static int nivel_vazio(const Roda* r, int nivel)
+{
+    for (int w = 0; w < RODA_ENCAIXES / 64; w++)
+        if (r->ocupados[nivel][w] != 0)
+            return FALSE;
+    return TRUE;
+}
+
+
+/* === INSERCAO === */
+// Tique corrente: insercao ordenada (poucos eventos por tique)
+static void prontos_inserir(Roda* r, NoRoda* no)
+{
+    NoRoda* anterior = NULL;
+    NoRoda* p = r->prontos;
+    while (p != NULL && !r->antes(no, p)) {
+        anterior = p;
+        p = p->proximo;
+    }
+    no->anterior = anterior;
+    no->proximo = p;
+    if (p != NULL)
+        p->anterior = no;
+    if (anterior != NULL)
+        anterior->proximo = no;
+    else
+        r->prontos = no;
+    no->local = RODA_PRONTOS;
+}
+
+// Coloca o no no nivel mais baixo que alcanca o seu tique, a partir do tique corrente
+static int posicionar(Roda* r, NoRoda* no)
+{
+    int64_t distancia = no->tique - r->atual;
+    if (distancia <= 0) {
+        prontos_inserir(r, no);
+        return TRUE;
+    }
+    for (int nivel = 0; nivel < RODA_NIVEIS; nivel++) {
+        if (distancia < (int64_t)1 << (RODA_BITS * (nivel + 1))) {
+            encaixe_inserir(r, nivel, (int)((no->tique >> (RODA_BITS * nivel)) & MASCARA), no);
+            return TRUE;
+        }
+    }
+    return heap_inserir(&r->distantes, no);
+}
+
+// Desce o conteudo de um encaixe para os niveis de baixo (ou para os prontos)
+static void cascatear(Roda* r, int nivel, int indice)
+{
+    uint64_t bit = (uint64_t)1 << (indice % 64);
+    if (!(r->ocupados[nivel][indice / 64] & bit))
+        return;
+    NoRoda* no = r->encaixes[nivel][indice];
+    r->ocupados[nivel][indice / 64] &= ~bit;
+    while (no != NULL) {
+        NoRoda* proximo = no->proximo;
+        r->n_roda--;
+        posicionar(r, no);
+        no = proximo;
+    }
+}
+
+// Eventos distantes que entraram no alcance da roda
+static void trazer_distantes(Roda* r)
+{
+    while (r->distantes.n > 0 && r->distantes.nos[0]->tique - r->atual < ALCANCE)
+        posicionar(r, heap_retirar(&r->distantes));
+}
+
+
+/* === AVANCO DO RELOGIO === */
+// Leva o tique corrente ao proximo ponto em que ha eventos e os coloca nos prontos
+static void avancar(Roda* r)
+{
+    if (r->n_roda == 0) {
+        // So ha eventos distantes: salta direto para o primeiro
+        r->atual = r->distantes.nos[0]->tique;
+        trazer_distantes(r);
+        return;
+    }
+
+    for (int nivel = 0; nivel < RODA_NIVEIS; nivel++) {
+        int deslocamento = RODA_BITS * nivel;
+        int corrente = (int)((r->atual >> deslocamento) & MASCARA);
+        int proximo = proximo_ocupado(r, nivel, corrente + 1);
+
+        if (proximo != -1) {
+            // Encaixe adiante na mesma volta: os niveis de baixo estao vazios, salta para ele
+            int64_t base = r->atual >> (deslocamento + RODA_BITS) << (deslocamento + RODA_BITS);
+            r->atual = base | ((int64_t)proximo << deslocamento);
+            cascatear(r, nivel, proximo);
+            trazer_distantes(r);
+            return;
+        }
+
+        if (!nivel_vazio(r, nivel)) {
+            // So restam encaixes da proxima volta deste nivel: avanca ate o inicio dela
+            int64_t volta = (int64_t)1 << (deslocamento + RODA_BITS);
+            r->atual = (r->atual / volta + 1) * volta;
+            for (int k = 1; k < RODA_NIVEIS; k++) {
+                int indice = (int)((r->atual >> (RODA_BITS * k)) & MASCARA);
+                cascatear(r, k, indice);
+                if (indice != 0)
+                    break;
+            }
+            cascatear(r, 0, (int)(r->atual & MASCARA));
+            trazer_distantes(r);
+            return;
+        }
+    }
+}
+
+
+/* === INTERFACE === */
+int roda_iniciar(Roda* r, double resolucao, FuncaoAntes antes, int capacidade_distantes)
+{
+    memset(r, 0, sizeof(*r));
+    r->resolucao = resolucao;
+    r->antes = antes;
+    return heap_iniciar(&r->distantes, capacidade_distantes, antes);
+}
+
+void roda_finalizar(Roda* r)
+{
+    heap_finalizar(&r->distantes);
+}
+
+void roda_reiniciar(Roda* r)
+{
+    memset(r->ocupados, 0, sizeof(r->ocupados));
+    r->prontos = NULL;
+    r->atual = 0;
+    r->n_roda = 0;
+    r->n = 0;
+    r->distantes.n = 0;
+}
+
+int roda_agendar(Roda* r, NoRoda* no, double tempo)
+{
+    no->tempo = tempo;
+    no->tique = (int64_t)(tempo / r->resolucao);
+    if (!posicionar(r, no))
+        return FALSE;
+    r->n++;
+    return TRUE;
+}
+
+void roda_cancelar(Roda* r, NoRoda* no)
+{
+    if (no->local == RODA_FORA)
+        return;
+    if (no->local == RODA_HEAP) {
+        heap_remover(&r->distantes, no);
+    } else if (no->local == RODA_PRONTOS) {
+        if (no->anterior != NULL)
+            no->anterior->proximo = no->proximo;
+        else
+            r->prontos = no->proximo;
+        if (no->proximo != NULL)
+            no->proximo->anterior = no->anterior;
+    } else {
+        encaixe_remover(r, no);
+    }
+    no->local = RODA_FORA;
+    r->n--;
+}
+
+NoRoda* roda_retirar(Roda* r)
+{
+    if (r->n == 0)
+        return NULL;
+    while (r->prontos == NULL)
+        avancar(r);
+
+    NoRoda* no = r->prontos;
+    r->prontos = no->proximo;
+    if (r->prontos != NULL)
+        r->prontos->anterior = NULL;
+    no->local = RODA_FORA;
+    r->n--;
+    return no;
+}
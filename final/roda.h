@@ -0,0 +1,79 @@
+#ifndef RODA_H
+#define RODA_H
+
+#include <stdint.h>
+
+/* === RODA DE TEMPO HIERARQUICA (fila de eventos do relogio virtual) === */
+// RODA_NIVEIS niveis de RODA_ENCAIXES encaixes: o nivel k agrupa 256^k tiques por encaixe.
+// Agendar e cancelar sao O(1); os encaixes de um nivel descem para o nivel de baixo
+// quando o relogio chega a eles (cascata). Eventos alem do alcance da roda (256^4 tiques)
+// ficam num heap e entram na roda quando se aproximam.
+//
+// A ordem de saida e exata, e nao apenas por tique: os eventos do tique corrente ficam
+// numa lista ordenada pela funcao antes(), que tambem desempata instantes iguais.
+#define RODA_NIVEIS 4
+#define RODA_BITS 8
+#define RODA_ENCAIXES (1 << RODA_BITS)
+
+// No intrusivo: fica no inicio do registro do evento (ver deterministico.c)
+typedef struct NoRoda
+{
+    double tempo;
+    int64_t tique;
+    struct NoRoda* proximo;
+    struct NoRoda* anterior;
+    int local;              // Nivel da roda, RODA_PRONTOS, RODA_HEAP ou RODA_FORA
+    int indice;             // Encaixe na roda ou posicao no heap
+} NoRoda;
+
+#define RODA_PRONTOS -1     // Lista ordenada do tique corrente
+#define RODA_HEAP -2        // Heap de eventos distantes
+#define RODA_FORA -3        // Retirado ou cancelado
+
+// Ordem total entre eventos (instante e desempates)
+typedef int (*FuncaoAntes)(const NoRoda* a, const NoRoda* b);
+
+/* === HEAP MINIMO DE NOS === */
+// Referencia para a bancada e reserva da roda para eventos distantes
+typedef struct
+{
+    NoRoda** nos;
+    int n;
+    int capacidade;
+    FuncaoAntes antes;
+} HeapNos;
+
+int heap_iniciar(HeapNos* h, int capacidade, FuncaoAntes antes);
+void heap_finalizar(HeapNos* h);
+int heap_inserir(HeapNos* h, NoRoda* no);
+NoRoda* heap_retirar(HeapNos* h);
+void heap_remover(HeapNos* h, NoRoda* no);
+
+typedef struct
+{
+    double resolucao;               // Segundos por tique
+    int64_t atual;                  // Tique corrente
+    NoRoda* encaixes[RODA_NIVEIS][RODA_ENCAIXES];
+    uint64_t ocupados[RODA_NIVEIS][RODA_ENCAIXES / 64];
+    NoRoda* prontos;                // Eventos do tique corrente, em ordem
+    int n_roda;                     // Nos nos encaixes (fora prontos e heap)
+    int n;                          // Total de eventos agendados
+    HeapNos distantes;
+    FuncaoAntes antes;
+} Roda;
+
+// Retorna FALSE sem memoria. capacidade_distantes e so o tamanho inicial do heap.
+int roda_iniciar(Roda* r, double resolucao, FuncaoAntes antes, int capacidade_distantes);
+void roda_finalizar(Roda* r);
+
+// Esvazia a roda e volta o relogio a zero, em O(1) (os nos pertencem ao chamador)
+void roda_reiniciar(Roda* r);
+
+// O instante do no nao pode ser anterior ao do ultimo evento retirado
+int roda_agendar(Roda* r, NoRoda* no, double tempo);
+void roda_cancelar(Roda* r, NoRoda* no);
+
+// Proximo evento em ordem, ou NULL com a roda vazia
+NoRoda* roda_retirar(Roda* r);
+
+#endif
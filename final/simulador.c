@@ -4,13 +4,39 @@
 #include <time.h>
 #include <pthread.h>
 #include <semaphore.h>
+#include <string.h>
+#include <limits.h>
+#include <signal.h>
+
+#include "relogio.h"
+#include "eta.h"
+#include "demanda.h"
+#include "zonas.h"
+#include "config.h"
+#include "aleatorio.h"
+#include "trafego.h"
+#include "checkpoint.h"
+#include "trace.h"
+#include "sinc.h"
+#include "metricas.h"
+#include "injecao.h"
+#include "compartilhado.h"
+#include "painel.h"
+#include "deterministico.h"
+#include "estresse.h"
+#include "portfolio.h"
+#include "antecipacao.h"
+#include "dimensionamento.h"
+#include "otimizador.h"
+#include "lote.h"
 
 
 /* === DEFINIÇÕES E CONSTANTES === */
 #define MAX_CHAMADAS 100
-#define MAX_ANDARES 50
-#define MAX_ELEVADORES 10
+#define MAX_ELEVADORES 256
 #define TAM_BUFFER 10
+#define TAM_FILA_ELEVADOR 8
+#define MAX_TENTATIVAS_DESPACHO 3   // Scheduler paralelo: reavaliacoes por conflito antes de aceitar
 #define TRUE 1
 #define FALSE 0
 
@@ -19,9 +45,15 @@
 // Chamada para elevador
 typedef struct 
 {
-    // int id;
+    int id;                 // Sequencial das chamadas dos andares; -1 se externa ou reposicionamento
     int origem;
-    int destino;
+    int destino;            // Fim do trecho atual (pode ser um andar de transferencia)
+    int reposicionamento;   // Deslocamento vazio do elevador (sem passageiro)
+    int destino_final;      // Destino pedido pelo passageiro
+    double instante;        // Chamada do passageiro (relogio da simulacao)
+    double instante_trecho; // Entrada do trecho atual no buffer
+    int externa;            // Recebida pelo socket de servico (nao conta em n_chamadas)
+    int pedido;             // Pedido externo aguardando resposta do scheduler (indice + 1); 0 se nenhum
 } Chamada;
 
 // Buffer de chamadas
@@ -41,68 +73,397 @@ typedef struct
     int chamadas_atendidas;
     sem_t sem_elevador_ocupou;
     Chamada chamada_atual;
+    int em_andamento;                   // chamada_atual ainda nao foi concluida
+    Chamada fila[TAM_FILA_ELEVADOR];    // Chamadas designadas ainda nao iniciadas
+    int fila_inicio;
+    int fila_contador;
+    int limite_fila;                    // Capacidade do elevador, limitada a TAM_FILA_ELEVADOR
+    pthread_mutex_t mutex_fila;
     int ocupado;
+    int encerrar;                       // Fila fechada: sai quando esvaziar (com mutex_fila)
+    int a_bordo;                        // Passageiro da chamada_atual ja embarcou
+    int destino_trecho;                 // Trecho em curso, publicado no segmento compartilhado
+    double partida_trecho;
+    double chegada_trecho;
+    EstatisticaSinc est_mutex_fila;
+    EstatisticaSinc est_sem_ocupou;
 } Elevador;
 
+// Despachante do scheduler paralelo: atende primeiro as chamadas com origem na sua
+// faixa de andares e, com ela vazia, rouba a mais antiga das outras faixas
+typedef struct
+{
+    pthread_t thread;
+    int andar_min;
+    int andar_max;
+    long proprias;
+    long roubadas;
+    long conflitos;         // Avaliacoes refeitas: outro despachante comprometeu o elevador antes
+} Despachante;
+
+// Resultado de designar_chamada_avaliada
+#define DESIGNACAO_RECUSADA 0
+#define DESIGNACAO_FEITA 1
+#define DESIGNACAO_CONFLITO 2
+
+// Andar produtor: gerador proprio e instante da proxima chamada
+typedef struct
+{
+    Aleatorio rng;
+    double proxima_chamada;
+} ProdutorAndar;
+
+// Estado de um elevador no checkpoint (fila em ordem, a partir do inicio)
+typedef struct
+{
+    int andar_atual;
+    int chamadas_atendidas;
+    int em_andamento;
+    int a_bordo;
+    Chamada chamada_atual;
+    int fila_contador;
+    Chamada fila[TAM_FILA_ELEVADOR];
+} ElevadorSalvo;
+
+// Cabecalho do checkpoint: identifica o edificio e o instante salvo
+typedef struct
+{
+    int n_andares;
+    int n_elevadores;
+    int n_chamadas;
+    int chamadas_geradas;
+    int chamadas_concluidas;
+    int chamadas_descartadas;
+    double instante;
+} CabecalhoSalvo;
+
 
 /* === VARIÁVEIS GLOBAIS === */
 // Parâmetros da simulação (definidos pelo usuário)
 int n_andares, n_elevadores, n_chamadas;
 int id_chamada = 0;
-int chamadas_geradas = 0;
+int chamadas_geradas = 0;       // Chamadas criadas pelos andares (com mutex_buffer)
+int simulacao_ativa = TRUE;     // Lida sem trava pela thread de estacionamento (atomicos)
+
+// Chamadas de passageiros ainda no sistema (buffer, filas ou viagem) e o destino das
+// que ja sairam. Protegidas por mutex_pendentes; main espera cond_drenado para encerrar.
+int chamadas_pendentes = 0;
+int chamadas_concluidas = 0;
+int chamadas_descartadas = 0;
+int aceitando_externas = TRUE;
+
+// Modelo do edificio (argumentos posicionais ou arquivo de configuracao)
+Predio predio;
 
-Elevador elevadores[MAX_ELEVADORES];
+Elevador* elevadores;
+ProdutorAndar* produtores;
+
+// Checkpoint: instante e arquivo de gravacao, arquivo de restauracao
+const char* arquivo_checkpoint = NULL;
+double instante_checkpoint = 0;
+const char* arquivo_restauracao = NULL;
+const char* arquivo_trace = NULL;
+const char* socket_metricas = NULL;
+const char* socket_servico = NULL;
+const char* nome_compartilhado = NULL;
+double quadros_painel = 0;
+int modo_deterministico = FALSE;
+int modo_estresse = FALSE;
+int teste_escala = FALSE;
+const char* digest_esperado = NULL;
+int geradores_internos = TRUE;
+int n_nucleos = 0;              // Pool de rollouts do despacho por antecipacao (0: todos)
+int n_despachantes = 1;         // Threads do scheduler; mais de uma particiona os andares
+Despachante* despachantes = NULL;
 
 // Estruturas de sincronizacao
 BufferChamadas buffer;
-pthread_mutex_t mutex_buffer, mutex_chamada, mutex_chamadas_geradas;
+int buffer_fechado = FALSE;     // Sem novas chamadas: o scheduler sai quando esvaziar (com mutex_buffer)
+pthread_mutex_t mutex_buffer, mutex_chamada, mutex_pendentes;
+pthread_cond_t cond_drenado;
 sem_t sem_buffer_ocupou, sem_buffer_liberou;
 
+// Encerramento: acorda a thread de estacionamento sem esperar o fim do periodo
+pthread_mutex_t mutex_encerramento = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t cond_encerramento;
+
+// Toda transicao de estado da simulacao acontece com a trava em modo leitura;
+// o checkpoint a adquire em modo escrita para observar um corte consistente
+pthread_rwlock_t trava_estado = PTHREAD_RWLOCK_INITIALIZER;
+
+// Estatisticas de disputa de cada ponto de sincronizacao (ver sinc.h)
+EstatisticaSinc est_mutex_buffer, est_mutex_chamada, est_mutex_pendentes, est_trava_estado;
+EstatisticaSinc est_sem_buffer_ocupou, est_sem_buffer_liberou;
+
+
+/* === BUFFER DE CHAMADAS === */
+// Reinsere no buffer o proximo trecho de uma viagem com transferencia entre zonas.
+// O espaco no buffer (sem_buffer_liberou) deve ter sido reservado pelo chamador.
+void reinserir_chamada(Chamada c, int trilha)
+{
+    sinc_travar(&mutex_buffer, &est_mutex_buffer, trilha);
+    buffer.chamadas[buffer.fim] = c;
+    buffer.fim = (buffer.fim + 1) % TAM_BUFFER;
+    buffer.contador++;
+    metricas_backlog(buffer.contador);
+    pthread_mutex_unlock(&mutex_buffer);
+    sem_post(&sem_buffer_ocupou);
+}
+
+// Chamada de passageiro saiu do sistema (entregue ou descartada); a ultima acorda main
+void chamada_encerrada(int concluida, int trilha)
+{
+    sinc_travar(&mutex_pendentes, &est_mutex_pendentes, trilha);
+    if (concluida)
+        chamadas_concluidas++;
+    else
+        chamadas_descartadas++;
+    if (--chamadas_pendentes == 0)
+        pthread_cond_broadcast(&cond_drenado);
+    pthread_mutex_unlock(&mutex_pendentes);
+}
+
+// Insere um lote de pedidos externos nas vagas livres do buffer, com uma unica
+// aquisicao da trava. Chamada pela thread de E/S do socket de servico.
+int injetar_chamadas(const ChamadaExterna* lote, int n)
+{
+    // Depois que main fecha a entrada, nenhum pedido novo entra na contagem de pendentes
+    sinc_travar(&mutex_pendentes, &est_mutex_pendentes, TRILHA_SERVICO);
+    int vagas = 0;
+    while (aceitando_externas && vagas < n && sem_trywait(&sem_buffer_liberou) == 0)
+        vagas++;
+    chamadas_pendentes += vagas;
+    pthread_mutex_unlock(&mutex_pendentes);
+    if (vagas == 0)
+        return 0;
+
+    sinc_travar_leitura(&trava_estado, &est_trava_estado, TRILHA_SERVICO);
+    sinc_travar(&mutex_buffer, &est_mutex_buffer, TRILHA_SERVICO);
+    double agora = relogio_agora();
+    for (int i = 0; i < vagas; i++) {
+        Chamada c = {.id = -1, .origem = lote[i].origem, .destino = lote[i].destino, .reposicionamento = FALSE,
+                     .destino_final = lote[i].destino, .instante = agora, .instante_trecho = agora,
+                     .externa = TRUE, .pedido = lote[i].pedido + 1};
+        buffer.chamadas[buffer.fim] = c;
+        buffer.fim = (buffer.fim + 1) % TAM_BUFFER;
+        buffer.contador++;
+        demanda_registrar(c.origem, agora);
+        metricas_chamada_gerada();
+        metricas_andar_aguardando(c.origem, 1);
+    }
+    metricas_backlog(buffer.contador);
+    pthread_mutex_unlock(&mutex_buffer);
+    pthread_rwlock_unlock(&trava_estado);
+
+    for (int i = 0; i < vagas; i++)
+        sem_post(&sem_buffer_ocupou);
+    return vagas;
+}
+
+
+/* === ESTADO COMPARTILHADO === */
+// Publica posicao, trecho, carga e proximas paradas do elevador no segmento compartilhado.
+// Chamar com mutex_fila adquirido (serializa os escritores do slot).
+void publicar_estado(Elevador* e)
+{
+    if (!compartilhado_ativo())
+        return;
+
+    EstadoElevador s;
+    memset(&s, 0, sizeof(s));
+    s.andar = e->andar_atual;
+    s.destino = e->destino_trecho;
+    s.direcao = (s.destino > s.andar) - (s.destino < s.andar);
+    s.partida_ms = (int32_t)(e->partida_trecho * 1000);
+    s.chegada_ms = (int32_t)(e->chegada_trecho * 1000);
+    s.carga = e->a_bordo;
+    s.atendidas = e->chamadas_atendidas;
+
+    // Paradas restantes da chamada em andamento, depois as da fila
+    int paradas[2 * (TAM_FILA_ELEVADOR + 1)];
+    int n = 0;
+    if (e->em_andamento) {
+        if (!e->a_bordo)
+            paradas[n++] = e->chamada_atual.origem;
+        if (!e->chamada_atual.reposicionamento)
+            paradas[n++] = e->chamada_atual.destino;
+    }
+    for (int k = 0; k < e->fila_contador; k++) {
+        Chamada* c = &e->fila[(e->fila_inicio + k) % TAM_FILA_ELEVADOR];
+        paradas[n++] = c->origem;
+        if (!c->reposicionamento)
+            paradas[n++] = c->destino;
+    }
+    for (int k = 0; k < n && k < COMPARTILHADO_MAX_PARADAS; k++)
+        s.paradas[k] = paradas[k];
+    s.n_paradas = n < COMPARTILHADO_MAX_PARADAS ? n : COMPARTILHADO_MAX_PARADAS;
+
+    compartilhado_publicar(e->id, &s);
+}
+
 
 /* === PADRAO SCHEDULER === */
-// SCHEDULER: Thread que gerencia o fluxo de chamadas entre andares e elevadores
+// Devolve ao cliente externo o elevador escolhido (ou o motivo da recusa) e o ETA
+void responder_pedido(const Chamada* c, int elevador, double eta)
+{
+    if (c->pedido > 0)
+        injecao_responder(c->pedido - 1, elevador, eta);
+}
+
+// Elevador so pode receber chamada se ainda houver espaco na sua fila.
+// Roda dentro do filtro do ETA, sem mutex_fila (a ordem e mutex_fila -> trava_eta):
+// a leitura e apenas indicativa e designar_chamada confere de novo.
+int elevador_aceita_chamada(int id)
+{
+    return __atomic_load_n(&elevadores[id].fila_contador, __ATOMIC_RELAXED) < elevadores[id].limite_fila;
+}
+
+// Designa chamada para o elevador avaliado na geracao dada do ETA (conferir = TRUE).
+// Com o scheduler paralelo, outro despachante pode ter escolhido o mesmo elevador entre a
+// avaliacao e a designacao: se ele recebeu parada (ou encheu) desde entao, a designacao
+// e recusada com DESIGNACAO_CONFLITO e o despachante reavalia a frota.
+int designar_chamada_avaliada(Elevador* e, Chamada c, int trilha, int conferir, unsigned long geracao)
+{
+    sinc_travar(&e->mutex_fila, &e->est_mutex_fila, trilha);
+    if (e->encerrar) {
+        pthread_mutex_unlock(&e->mutex_fila);
+        return DESIGNACAO_RECUSADA;
+    }
+    if (conferir && (e->fila_contador >= e->limite_fila || eta_comprometido_desde(e->id, geracao))) {
+        pthread_mutex_unlock(&e->mutex_fila);
+        return DESIGNACAO_CONFLITO;
+    }
+    if (e->fila_contador >= e->limite_fila) {
+        pthread_mutex_unlock(&e->mutex_fila);
+        return DESIGNACAO_RECUSADA;
+    }
+    e->fila[(e->fila_inicio + e->fila_contador) % TAM_FILA_ELEVADOR] = c;
+    __atomic_store_n(&e->fila_contador, e->fila_contador + 1, __ATOMIC_RELAXED);
+    e->ocupado = TRUE;
+    metricas_elevador_fila(e->id, e->fila_contador, TRUE);
+    publicar_estado(e);
+
+    double agora = relogio_agora();
+    eta_comprometer_parada(e->id, c.origem, agora);
+    if (!c.reposicionamento)
+        eta_comprometer_parada(e->id, c.destino, agora);
+    pthread_mutex_unlock(&e->mutex_fila);
+    return DESIGNACAO_FEITA;
+}
+
+// Designa chamada para o elevador: entra na fila dele e compromete as paradas no ETA
+int designar_chamada(Elevador* e, Chamada c, int trilha)
+{
+    return designar_chamada_avaliada(e, c, trilha, FALSE, 0) == DESIGNACAO_FEITA;
+}
+
+// Retira do buffer a chamada mais antiga com origem na faixa do despachante; sem nenhuma,
+// a mais antiga de todas (roubo). Sem despachante (scheduler unico), a primeira (FIFO).
+// Chamar com mutex_buffer adquirido e o buffer nao vazio.
+Chamada retirar_chamada(Despachante* d)
+{
+    int k = 0;
+    if (d != NULL) {
+        while (k < buffer.contador) {
+            int origem = buffer.chamadas[(buffer.inicio + k) % TAM_BUFFER].origem;
+            if (origem >= d->andar_min && origem <= d->andar_max)
+                break;
+            k++;
+        }
+        if (k == buffer.contador) {
+            k = 0;
+            d->roubadas++;
+        } else {
+            d->proprias++;
+        }
+    }
+
+    // Fecha a vaga deslocando as mais antigas uma posicao adiante (a ordem se mantem)
+    Chamada c = buffer.chamadas[(buffer.inicio + k) % TAM_BUFFER];
+    for (int j = k; j > 0; j--)
+        buffer.chamadas[(buffer.inicio + j) % TAM_BUFFER] = buffer.chamadas[(buffer.inicio + j - 1) % TAM_BUFFER];
+    buffer.inicio = (buffer.inicio + 1) % TAM_BUFFER;
+    buffer.contador--;
+    return c;
+}
+
+// SCHEDULER: Thread que gerencia o fluxo de chamadas entre andares e elevadores.
+// arg: Despachante* no scheduler paralelo (varias threads consomem o mesmo buffer), ou NULL.
 void* funcao_scheduler(void* arg)
 {
+    Despachante* d = (Despachante*)arg;
     while (TRUE) {
         // Aguarda ter chamada no buffer e adquire tranca
-        sem_wait(&sem_buffer_ocupou);
-        pthread_mutex_lock(&mutex_buffer);
+        sinc_esperar(&sem_buffer_ocupou, &est_sem_buffer_ocupou, -1);
+        double inicio_despacho = relogio_agora();
+        sinc_travar_leitura(&trava_estado, &est_trava_estado, TRILHA_SCHEDULER);
+        sinc_travar(&mutex_buffer, &est_mutex_buffer, TRILHA_SCHEDULER);
 
-        // Garante que o scheduler nunca tente acessar o buffer vazio
+        // Buffer vazio: ficha de encerramento (buffer fechado) ou sinal sem chamada
         if (buffer.contador == 0) {
+            int fechado = buffer_fechado;
             pthread_mutex_unlock(&mutex_buffer);
+            pthread_rwlock_unlock(&trava_estado);
+            if (fechado)
+                break;
             continue;
         }
 
-        // Acessa a primeira chamada do buffer (FIFO)
-        Chamada c = buffer.chamadas[buffer.inicio];
-        buffer.inicio = (buffer.inicio + 1) % TAM_BUFFER;
-        buffer.contador--;
+        // Acessa a primeira chamada do buffer (FIFO), ou a primeira da faixa do despachante
+        Chamada c = retirar_chamada(d);
+        metricas_backlog(buffer.contador);
 
         // Libera tranca e sinaliza espaco livre no buffer
         pthread_mutex_unlock(&mutex_buffer);
         sem_post(&sem_buffer_liberou);
 
-        // Escolhe o elevador mais próximo do andar de origem
-        int melhor_id = -1;
-        int menor_dist = MAX_ANDARES;
+        // Restringe a chamada ao trecho atendido por uma unica zona
+        Trecho t;
+        if (!zonas_proximo_trecho(c.origem, c.destino_final, &t)) {
+            printf("[Scheduler] Nenhuma zona atende a chamada %d -> %d\n", c.origem, c.destino_final);
+            metricas_chamada_descartada();
+            metricas_andar_aguardando(c.origem, -1);
+            estresse_descartada(c.id);
+            responder_pedido(&c, INJECAO_SEM_ELEVADOR, 0);
+            chamada_encerrada(FALSE, TRILHA_SCHEDULER);
+            pthread_rwlock_unlock(&trava_estado);
+            continue;
+        }
+        c.destino = t.destino;
 
-        // Percorre array de elevadores e escolhe o mais proximo
-        for (int i = 0; i < n_elevadores; i++) {
-            if (!elevadores[i].ocupado) {
-                int dist = abs(elevadores[i].andar_atual - c.origem);
-                if (dist < menor_dist) {
-                    menor_dist = dist;
-                    melhor_id = i;
-                }
-            }
+        // Escolhe, entre os elevadores da zona, o que chega antes ao andar de origem
+        // (menor ETA), considerando as paradas que cada um ja tem comprometidas.
+        // Despachantes avaliam em paralelo (ETA em modo leitura) e conferem a escolha ao
+        // designar; a ultima tentativa aceita a avaliacao sem conferir.
+        const Zona* zona = zonas_obter(t.zona);
+        double agora, eta;
+        int melhor_id;
+        int resultado = DESIGNACAO_CONFLITO;
+        for (int tentativa = 1; resultado == DESIGNACAO_CONFLITO; tentativa++) {
+            unsigned long geracao = eta_geracao();
+            agora = relogio_agora();
+            melhor_id = eta_melhor_elevador_em(zona->elevadores, zona->n_elevadores, c.origem,
+                                               agora, elevador_aceita_chamada, &eta);
+            if (melhor_id == -1)
+                break;
+            int conferir = d != NULL && tentativa < MAX_TENTATIVAS_DESPACHO;
+            resultado = designar_chamada_avaliada(&elevadores[melhor_id], c, TRILHA_SCHEDULER, conferir, geracao);
+            if (resultado == DESIGNACAO_CONFLITO)
+                d->conflitos++;
         }
 
-        // Designa chamada para elevador mais proximo
-        if (melhor_id != -1) {
-            elevadores[melhor_id].chamada_atual = c;
-            elevadores[melhor_id].ocupado = TRUE;
-            printf("[Scheduler] Chamada para elevador %d\n", melhor_id);
+        // Designa chamada para elevador de menor ETA
+        if (melhor_id != -1 && resultado == DESIGNACAO_FEITA) {
+            printf("[Scheduler] Chamada para elevador %d (ETA %.1fs)\n", melhor_id, eta - agora);
+            metricas_chamada_despachada();
+            estresse_progresso();
+            responder_pedido(&c, melhor_id, eta - agora);
+            if (trace_ativo) {
+                char args[128];
+                snprintf(args, sizeof(args), "{\"origem\":%d,\"destino\":%d,\"elevador\":%d,\"eta\":%.3f}",
+                         c.origem, c.destino, melhor_id, eta - agora);
+                trace_span(TRILHA_SCHEDULER, "despacho", inicio_despacho, relogio_agora(), args);
+            }
 
             // Sinaliza que elevador ocupou
             sem_post(&elevadores[melhor_id].sem_elevador_ocupou);
@@ -110,7 +471,13 @@ void* funcao_scheduler(void* arg)
             // Nenhum elevador disponível
             //, pode implementar fila ou esperar (simplesmente descarta neste exemplo)
             printf("[Scheduler] Nenhum elevador disponível para a chamada\n");
+            metricas_chamada_descartada();
+            metricas_andar_aguardando(c.origem, -1);
+            estresse_descartada(c.id);
+            responder_pedido(&c, INJECAO_SEM_ELEVADOR, 0);
+            chamada_encerrada(FALSE, TRILHA_SCHEDULER);
         }
+        pthread_rwlock_unlock(&trava_estado);
 
         usleep(250);
     }
@@ -122,82 +489,210 @@ void* funcao_scheduler(void* arg)
 // PRODUTOR: Threads dos andares produtores de chamadas
 void* funcao_andar(void* arg) {
     int origem = *(int*)arg;
-    free(arg);
+    ProdutorAndar* p = &produtores[origem];
 
     while (TRUE) {
+        // Aguarda o instante da proxima chamada deste andar
+        relogio_esperar_ate(p->proxima_chamada);
+
         // Espera espaco livre no buffer e adquire tranca
-        sem_wait(&sem_buffer_liberou);
-        pthread_mutex_lock(&mutex_buffer);
+        sinc_esperar(&sem_buffer_liberou, &est_sem_buffer_liberou, TRILHA_ANDAR(origem));
+        sinc_travar_leitura(&trava_estado, &est_trava_estado, TRILHA_ANDAR(origem));
+        sinc_travar(&mutex_buffer, &est_mutex_buffer, TRILHA_ANDAR(origem));
         
-        // Verifica se já atingimos o limite de chamadas
+        // Verifica se já atingimos o limite de chamadas (devolve a vaga reservada)
         if (chamadas_geradas >= n_chamadas) {
             pthread_mutex_unlock(&mutex_buffer);
+            pthread_rwlock_unlock(&trava_estado);
+            sem_post(&sem_buffer_liberou);
             break;
         }
 
         // Garante que andar destino e diferente de origem
-        int destino;
-        do {
-            destino = rand() % n_andares;
-        } while (destino == origem); 
+        int destino = trafego_destino(&predio.trafego, &p->rng, origem, n_andares);
 
         // Cria nova chamada
-        pthread_mutex_lock(&mutex_chamada);
-        Chamada c = {origem, destino};
+        sinc_travar(&mutex_chamada, &est_mutex_chamada, TRILHA_ANDAR(origem));
+        double agora = relogio_agora();
+        Chamada c = {.id = id_chamada++, .origem = origem, .destino = destino, .reposicionamento = FALSE,
+                     .destino_final = destino, .instante = agora, .instante_trecho = agora};
         pthread_mutex_unlock(&mutex_chamada);
+        demanda_registrar(origem, agora);
 
         chamadas_geradas++;
+        sinc_travar(&mutex_pendentes, &est_mutex_pendentes, TRILHA_ANDAR(origem));
+        chamadas_pendentes++;
+        pthread_mutex_unlock(&mutex_pendentes);
+        metricas_chamada_gerada();
+        metricas_andar_aguardando(origem, 1);
+        estresse_progresso();
 
         // Insere chamada no buffer
         buffer.chamadas[buffer.fim] = c;
         buffer.fim = (buffer.fim + 1) % TAM_BUFFER;
         buffer.contador++;
+        metricas_backlog(buffer.contador);
 
         printf("[Andar %d] Nova chamada: %d -> %d\n", origem, c.origem, c.destino);
+        if (trace_ativo) {
+            char args[64];
+            snprintf(args, sizeof(args), "{\"origem\":%d,\"destino\":%d}", c.origem, c.destino);
+            trace_instante(TRILHA_ANDAR(origem), "chamada", relogio_agora(), args);
+        }
+
+        // Sorteia o intervalo (perfil de trafego) ate a proxima chamada deste andar, contado
+        // do instante previsto desta: o tempo gasto nas travas nao se acumula
+        p->proxima_chamada += trafego_intervalo(&predio.trafego, &p->rng, origem);
 
         // Libera tranca e sinaliza que  há chamada disponível
         pthread_mutex_unlock(&mutex_buffer);
+        pthread_rwlock_unlock(&trava_estado);
         sem_post(&sem_buffer_ocupou);
-
-        // Aguarda um tempo aleatorio (1-4seg) ate criar nova chamada
-        sleep(rand() % 3 + 1);
     }
     return 0;
 }
 
+// Simula o deslocamento do elevador ate o andar (trecho de viagem seguido do ciclo de portas),
+// segundo o modelo de viagem dele. Com embarque, o passageiro da chamada_atual embarca na
+// chegada, no mesmo corte do checkpoint que o novo andar.
+void simular_viagem(Elevador* e, int destino, const char* motivo, int embarque)
+{
+    double porta = eta_tempo_porta(e->id);
+    double inicio = relogio_agora();
+    double duracao = eta_tempo_viagem(e->id, e->andar_atual, destino);
+    metricas_elevador_trecho(e->id, destino);
+    if (compartilhado_ativo()) {
+        sinc_travar(&e->mutex_fila, &e->est_mutex_fila, TRILHA_ELEVADOR(e->id));
+        e->destino_trecho = destino;
+        e->partida_trecho = inicio;
+        e->chegada_trecho = inicio + duracao;
+        publicar_estado(e);
+        pthread_mutex_unlock(&e->mutex_fila);
+    }
+    relogio_esperar_ate(inicio + duracao - porta);
+    double chegada = relogio_agora();
+    relogio_esperar_ate(inicio + duracao);
+
+    if (trace_ativo) {
+        char args[64];
+        snprintf(args, sizeof(args), "{\"de\":%d,\"para\":%d}", e->andar_atual, destino);
+        trace_span(TRILHA_ELEVADOR(e->id), motivo, inicio, chegada, args);
+        if (porta > 0)
+            trace_span(TRILHA_ELEVADOR(e->id), "portas", chegada, relogio_agora(), NULL);
+    }
+
+    // andar_atual e lido pela thread de estacionamento com mutex_fila
+    sinc_travar_leitura(&trava_estado, &est_trava_estado, TRILHA_ELEVADOR(e->id));
+    sinc_travar(&e->mutex_fila, &e->est_mutex_fila, TRILHA_ELEVADOR(e->id));
+    e->andar_atual = destino;
+    if (embarque)
+        e->a_bordo = TRUE;
+    eta_registrar_parada(e->id, destino, relogio_agora());
+    metricas_elevador_andar(e->id, destino);
+    publicar_estado(e);
+    pthread_mutex_unlock(&e->mutex_fila);
+    pthread_rwlock_unlock(&trava_estado);
+}
+
+// Conclui a chamada em andamento do elevador (fica livre quando a fila esvazia)
+void concluir_chamada(Elevador* e, int atendida)
+{
+    sinc_travar(&e->mutex_fila, &e->est_mutex_fila, TRILHA_ELEVADOR(e->id));
+    if (atendida) {
+        e->chamadas_atendidas++;
+        metricas_elevador_atendida(e->id);
+    }
+    e->em_andamento = FALSE;
+    e->a_bordo = FALSE;
+    if (e->fila_contador == 0)
+        e->ocupado = FALSE;
+    metricas_elevador_fila(e->id, e->fila_contador, e->ocupado);
+    publicar_estado(e);
+    pthread_mutex_unlock(&e->mutex_fila);
+}
+
 // CONSUMIDOR: Threads dos elevadores consumidores de chamadas
 void* funcao_elevador(void* arg) {
     Elevador* e = (Elevador*)arg;
 
     while (TRUE) {
-        // Aguarda sinal do scheduler
-        sem_wait(&e->sem_elevador_ocupou);
+        Chamada c;
+        int a_bordo = FALSE;
+        if (e->em_andamento) {
+            // Chamada em andamento restaurada de um checkpoint: retoma sem passar pela fila
+            // (so esta thread altera em_andamento depois de criada)
+            c = e->chamada_atual;
+            a_bordo = e->a_bordo;
+        } else {
+            // Aguarda sinal do scheduler (ou a ficha de encerramento)
+            sinc_esperar(&e->sem_elevador_ocupou, &e->est_sem_ocupou, -1);
+
+            // Retira a proxima chamada da fila do elevador
+            sinc_travar_leitura(&trava_estado, &est_trava_estado, TRILHA_ELEVADOR(e->id));
+            sinc_travar(&e->mutex_fila, &e->est_mutex_fila, TRILHA_ELEVADOR(e->id));
+            if (e->fila_contador == 0 && e->encerrar) {
+                pthread_mutex_unlock(&e->mutex_fila);
+                pthread_rwlock_unlock(&trava_estado);
+                break;
+            }
+            c = e->fila[e->fila_inicio];
+            e->fila_inicio = (e->fila_inicio + 1) % TAM_FILA_ELEVADOR;
+            __atomic_store_n(&e->fila_contador, e->fila_contador - 1, __ATOMIC_RELAXED);
+            e->chamada_atual = c;
+            e->em_andamento = TRUE;
+            metricas_elevador_fila(e->id, e->fila_contador, TRUE);
+            publicar_estado(e);
+            pthread_mutex_unlock(&e->mutex_fila);
+            pthread_rwlock_unlock(&trava_estado);
+        }
+
+        // Reposicionamento: apenas desloca o elevador vazio ate o andar de estacionamento
+        if (c.reposicionamento) {
+            printf("[Elevador %d] De %d para %d (estacionando)\n", e->id, e->andar_atual, c.origem);
+            simular_viagem(e, c.origem, "viagem (estacionamento)", FALSE);
 
-        // Designa nova chamada
-        Chamada c = e->chamada_atual;
+            sinc_travar_leitura(&trava_estado, &est_trava_estado, TRILHA_ELEVADOR(e->id));
+            concluir_chamada(e, FALSE);
+            pthread_rwlock_unlock(&trava_estado);
+            continue;
+        }
 
-        // Simula movimento de andar atual para origem da chamada
-        printf("[Elevador %d] De %d para %d (atendendo origem da chamada)\n", e->id, e->andar_atual, c.origem);
-        sleep(abs(e->andar_atual - c.origem));  
-        e->andar_atual = c.origem;
+        // Simula movimento de andar atual para origem da chamada (restaurada com o
+        // passageiro a bordo: ele ja embarcou e a espera ja foi contada)
+        if (!a_bordo) {
+            printf("[Elevador %d] De %d para %d (atendendo origem da chamada)\n", e->id, e->andar_atual, c.origem);
+            simular_viagem(e, c.origem, "viagem (origem)", TRUE);
+            metricas_espera(relogio_agora() - c.instante_trecho);
+            metricas_andar_aguardando(c.origem, -1);
+        }
 
         // Simula movimento de andar origem para destino da chamada
         printf("[Elevador %d] De %d para %d (indo para destino da chamada)\n", e->id, e->andar_atual, c.destino);
-        sleep(abs(c.destino - e->andar_atual));
-        e->andar_atual = c.destino;
+        simular_viagem(e, c.destino, "viagem (destino)", FALSE);
 
-        // Atualiza estado do elevador
-        e->chamadas_atendidas++;
-        e->ocupado = FALSE;
-
-        // Atualiza chamadas concluidas
-        pthread_mutex_lock(&mutex_chamadas_geradas);
-        chamadas_geradas++;
-        if (chamadas_geradas >= n_chamadas) {
-            pthread_mutex_unlock(&mutex_chamadas_geradas);
-            break;
+        // Passageiro desembarcou num andar de transferencia: segue em outra zona
+        if (c.destino != c.destino_final) {
+            printf("[Elevador %d] Passageiro transfere no andar %d (destino %d)\n", e->id, c.destino, c.destino_final);
+            Chamada proximo = {.id = c.id, .origem = c.destino, .destino = c.destino_final,
+                               .reposicionamento = FALSE, .destino_final = c.destino_final,
+                               .instante = c.instante, .instante_trecho = relogio_agora(),
+                               .externa = c.externa};
+            sinc_esperar(&sem_buffer_liberou, &est_sem_buffer_liberou, TRILHA_ELEVADOR(e->id));
+            sinc_travar_leitura(&trava_estado, &est_trava_estado, TRILHA_ELEVADOR(e->id));
+            reinserir_chamada(proximo, TRILHA_ELEVADOR(e->id));
+            metricas_andar_aguardando(proximo.origem, 1);
+            concluir_chamada(e, TRUE);
+            pthread_rwlock_unlock(&trava_estado);
+            continue;
         }
-        pthread_mutex_unlock(&mutex_chamadas_geradas);
+
+        // Atualiza estado do elevador e chamadas concluidas
+        metricas_viagem(relogio_agora() - c.instante);
+        estresse_atendida(c.id);
+        sinc_travar_leitura(&trava_estado, &est_trava_estado, TRILHA_ELEVADOR(e->id));
+        concluir_chamada(e, TRUE);
+        chamada_encerrada(TRUE, TRILHA_ELEVADOR(e->id));
+        pthread_rwlock_unlock(&trava_estado);
 
         printf("[Elevador %d] Chamada concluida. Subtotal atendidas: %d\n", e->id, e->chamadas_atendidas);
     }
@@ -206,101 +701,914 @@ void* funcao_elevador(void* arg) {
 }
 
 
+/* === POLITICA DE ESTACIONAMENTO === */
+// Espera ate o instante do relogio da simulacao; retorna FALSE se o encerramento chegou antes
+int aguardar_ate(double instante)
+{
+    struct timespec prazo;
+    relogio_prazo(instante, &prazo);
+    pthread_mutex_lock(&mutex_encerramento);
+    while (__atomic_load_n(&simulacao_ativa, __ATOMIC_ACQUIRE)
+           && pthread_cond_timedwait(&cond_encerramento, &mutex_encerramento, &prazo) == 0)
+        ;
+    pthread_mutex_unlock(&mutex_encerramento);
+    return __atomic_load_n(&simulacao_ativa, __ATOMIC_ACQUIRE);
+}
+
+// Thread que reposiciona elevadores ociosos nos andares de maior demanda observada.
+// Roda fora do caminho critico: o scheduler nunca espera por ela.
+void* funcao_estacionamento(void* arg)
+{
+    int alvos[n_elevadores];
+    int livres[n_elevadores];
+    int andar_livre[n_elevadores];  // Andar de cada elevador ocioso, lido com mutex_fila
+
+    double proxima_rodada = relogio_agora();
+    while (aguardar_ate(proxima_rodada += predio.politica.periodo_estacionamento)) {
+        // Coleta elevadores ociosos (sem chamada em andamento nem na fila)
+        int n_livres = 0;
+        for (int i = 0; i < n_elevadores; i++) {
+            sinc_travar(&elevadores[i].mutex_fila, &elevadores[i].est_mutex_fila, TRILHA_ESTACIONAMENTO);
+            if (!elevadores[i].ocupado) {
+                andar_livre[n_livres] = elevadores[i].andar_atual;
+                livres[n_livres++] = i;
+            }
+            pthread_mutex_unlock(&elevadores[i].mutex_fila);
+        }
+        if (n_livres == 0)
+            continue;
+
+        // Um andar alvo por elevador ocioso, do mais para o menos demandado
+        int n_alvos = demanda_andares_mais_demandados(relogio_agora(), alvos, n_livres);
+
+        // Alvos ja cobertos por um elevador ocioso parado neles nao precisam de outro
+        for (int a = 0; a < n_alvos; a++) {
+            for (int k = 0; k < n_livres; k++) {
+                if (livres[k] != -1 && andar_livre[k] == alvos[a]) {
+                    livres[k] = -1;
+                    alvos[a] = -1;
+                    break;
+                }
+            }
+        }
+
+        // Demais alvos recebem o elevador ocioso mais proximo
+        for (int a = 0; a < n_alvos; a++) {
+            if (alvos[a] == -1)
+                continue;
+
+            int melhor_k = -1;
+            int menor_dist = 0;
+            for (int k = 0; k < n_livres; k++) {
+                if (livres[k] == -1 || !zonas_cobre(zonas_do_elevador(livres[k]), alvos[a]))
+                    continue;
+                int dist = abs(andar_livre[k] - alvos[a]);
+                if (melhor_k == -1 || dist < menor_dist) {
+                    menor_dist = dist;
+                    melhor_k = k;
+                }
+            }
+            if (melhor_k == -1)
+                break;
+
+            Elevador* e = &elevadores[livres[melhor_k]];
+            livres[melhor_k] = -1;
+            Chamada c = {.id = -1, .origem = alvos[a], .destino = alvos[a], .reposicionamento = TRUE,
+                         .destino_final = alvos[a]};
+            sinc_travar_leitura(&trava_estado, &est_trava_estado, TRILHA_ESTACIONAMENTO);
+            int designada = designar_chamada(e, c, TRILHA_ESTACIONAMENTO);
+            pthread_rwlock_unlock(&trava_estado);
+            if (designada) {
+                printf("[Estacionamento] Elevador %d -> andar %d (demanda %.2f chamadas/s)\n",
+                       e->id, alvos[a], demanda_taxa(alvos[a], relogio_agora()));
+                sem_post(&e->sem_elevador_ocupou);
+            }
+        }
+    }
+    return 0;
+}
+
+
+/* === CHECKPOINT E RESTAURACAO === */
+// Grava o estado completo da simulacao. Chamar com trava_estado em modo escrita.
+int salvar_estado(const char* caminho)
+{
+    Checkpoint c;
+    if (!checkpoint_abrir_escrita(&c, caminho))
+        return FALSE;
+
+    CabecalhoSalvo cab = {n_andares, n_elevadores, n_chamadas, chamadas_geradas, chamadas_concluidas,
+                          chamadas_descartadas, relogio_agora()};
+    checkpoint_escrever(&c, &cab, sizeof(cab));
+    checkpoint_escrever(&c, &buffer, sizeof(buffer));
+
+    for (int i = 0; i < n_elevadores; i++) {
+        Elevador* e = &elevadores[i];
+        ElevadorSalvo es;
+        memset(&es, 0, sizeof(es));
+        es.andar_atual = e->andar_atual;
+        es.chamadas_atendidas = e->chamadas_atendidas;
+        es.em_andamento = e->em_andamento;
+        es.a_bordo = e->a_bordo;
+        es.chamada_atual = e->chamada_atual;
+        es.fila_contador = e->fila_contador;
+        for (int k = 0; k < e->fila_contador; k++)
+            es.fila[k] = e->fila[(e->fila_inicio + k) % TAM_FILA_ELEVADOR];
+        checkpoint_escrever(&c, &es, sizeof(es));
+    }
+
+    // Geradores e proximas chamadas dos andares (eventos pendentes dos produtores)
+    checkpoint_escrever(&c, produtores, n_andares * sizeof(ProdutorAndar));
+    demanda_salvar(&c);
+    return checkpoint_fechar_escrita(&c);
+}
+
+// Restaura o estado salvo, antes da criacao das threads. Uma chamada que estava em
+// andamento continua em andamento, fora da fila: a thread do elevador a retoma a partir
+// do ultimo andar alcancado, e com o passageiro a bordo faz so o trecho ate o destino.
+int restaurar_estado(const char* caminho)
+{
+    Checkpoint c;
+    if (!checkpoint_abrir_leitura(&c, caminho))
+        return FALSE;
+
+    CabecalhoSalvo cab;
+    checkpoint_ler(&c, &cab, sizeof(cab));
+    if (!c.erro && (cab.n_andares != n_andares || cab.n_elevadores != n_elevadores || cab.n_chamadas != n_chamadas)) {
+        printf("Erro: checkpoint de outro edificio (%d andares, %d elevadores, %d chamadas)\n",
+               cab.n_andares, cab.n_elevadores, cab.n_chamadas);
+        c.erro = TRUE;
+        checkpoint_fechar_leitura(&c);
+        return FALSE;
+    }
+    chamadas_geradas = cab.chamadas_geradas;
+    chamadas_concluidas = cab.chamadas_concluidas;
+    chamadas_descartadas = cab.chamadas_descartadas;
+    id_chamada = chamadas_geradas;
+    checkpoint_ler(&c, &buffer, sizeof(buffer));
+
+    // Conexoes do socket de servico nao sobrevivem ao checkpoint: ninguem espera a resposta
+    for (int k = 0; k < TAM_BUFFER; k++)
+        buffer.chamadas[k].pedido = 0;
+
+    relogio_iniciar_em(cab.instante);
+    for (int i = 0; i < n_elevadores; i++) {
+        Elevador* e = &elevadores[i];
+        ElevadorSalvo es;
+        checkpoint_ler(&c, &es, sizeof(es));
+        e->andar_atual = es.andar_atual;
+        e->chamadas_atendidas = es.chamadas_atendidas;
+        e->em_andamento = es.em_andamento;
+        e->a_bordo = es.em_andamento && es.a_bordo;
+        e->chamada_atual = es.chamada_atual;
+        e->fila_inicio = 0;
+        e->fila_contador = 0;
+        for (int k = 0; k < es.fila_contador && e->fila_contador < TAM_FILA_ELEVADOR; k++)
+            e->fila[e->fila_contador++] = es.fila[k];
+        e->ocupado = e->em_andamento || e->fila_contador > 0;
+
+        // Reconstroi o cache de ETA a partir da posicao, da chamada em andamento e da fila
+        eta_registrar_parada(i, e->andar_atual, cab.instante);
+        if (e->em_andamento) {
+            if (!e->a_bordo)
+                eta_comprometer_parada(i, e->chamada_atual.origem, cab.instante);
+            if (!e->chamada_atual.reposicionamento)
+                eta_comprometer_parada(i, e->chamada_atual.destino, cab.instante);
+        }
+        for (int k = 0; k < e->fila_contador; k++) {
+            eta_comprometer_parada(i, e->fila[k].origem, cab.instante);
+            if (!e->fila[k].reposicionamento)
+                eta_comprometer_parada(i, e->fila[k].destino, cab.instante);
+        }
+    }
+
+    checkpoint_ler(&c, produtores, n_andares * sizeof(ProdutorAndar));
+    demanda_restaurar(&c);
+    if (!checkpoint_fechar_leitura(&c))
+        return FALSE;
+
+    // Passageiros restaurados no buffer, em viagem e nas filas ainda precisam ser entregues
+    for (int k = 0; k < buffer.contador; k++)
+        chamadas_pendentes += !buffer.chamadas[(buffer.inicio + k) % TAM_BUFFER].reposicionamento;
+    for (int i = 0; i < n_elevadores; i++) {
+        chamadas_pendentes += elevadores[i].em_andamento && !elevadores[i].chamada_atual.reposicionamento;
+        for (int k = 0; k < elevadores[i].fila_contador; k++)
+            chamadas_pendentes += !elevadores[i].fila[k].reposicionamento;
+    }
+
+    printf("[Checkpoint] Estado restaurado de %s (t=%.1fs, %d chamadas geradas)\n",
+           caminho, cab.instante, chamadas_geradas);
+    return TRUE;
+}
+
+// Thread que grava o checkpoint no instante pedido, pausando a simulacao durante a gravacao
+void* funcao_checkpoint(void* arg)
+{
+    // O encerramento antes do instante interrompe a espera: nada a gravar
+    if (!aguardar_ate(instante_checkpoint))
+        return 0;
+
+    sinc_travar_escrita(&trava_estado, &est_trava_estado, TRILHA_CHECKPOINT);
+    double inicio_gravacao = relogio_agora();
+    if (simulacao_ativa) {
+        if (salvar_estado(arquivo_checkpoint))
+            printf("[Checkpoint] Estado salvo em %s (t=%.1fs)\n", arquivo_checkpoint, relogio_agora());
+        else
+            printf("[Checkpoint] Falha ao gravar %s\n", arquivo_checkpoint);
+        trace_span(TRILHA_CHECKPOINT, "checkpoint", inicio_gravacao, relogio_agora(), NULL);
+    }
+    pthread_rwlock_unlock(&trava_estado);
+    return 0;
+}
+
+// Chamada pelo vigia do modo de estresse quando a simulacao para de progredir.
+// Usa trylock: a thread travada pode estar segurando justamente estes mutexes.
+void despejar_estado(void)
+{
+    int travou = pthread_mutex_trylock(&mutex_buffer) == 0;
+    fprintf(stderr, "Buffer%s: %d chamadas, geradas %d de %d\n", travou ? "" : " (mutex ocupado)",
+            buffer.contador, chamadas_geradas, n_chamadas);
+    for (int k = 0; k < buffer.contador && k < TAM_BUFFER; k++) {
+        Chamada* c = &buffer.chamadas[(buffer.inicio + k) % TAM_BUFFER];
+        fprintf(stderr, "  #%d %d -> %d\n", c->id, c->origem, c->destino);
+    }
+    if (travou)
+        pthread_mutex_unlock(&mutex_buffer);
+
+    for (int i = 0; i < n_elevadores; i++) {
+        Elevador* e = &elevadores[i];
+        travou = pthread_mutex_trylock(&e->mutex_fila) == 0;
+        fprintf(stderr, "Elevador %d%s: andar %d, ocupado %d, fila %d, atendidas %d\n", i,
+                travou ? "" : " (mutex ocupado)", e->andar_atual, e->ocupado, e->fila_contador,
+                e->chamadas_atendidas);
+        for (int k = 0; k < e->fila_contador && k < TAM_FILA_ELEVADOR; k++) {
+            Chamada* c = &e->fila[(e->fila_inicio + k) % TAM_FILA_ELEVADOR];
+            fprintf(stderr, "  #%d %d -> %d%s\n", c->id, c->origem, c->destino,
+                    c->reposicionamento ? " (reposicionamento)" : "");
+        }
+        if (travou)
+            pthread_mutex_unlock(&e->mutex_fila);
+    }
+}
+
+
+/* === PORTFOLIO === */
+// simulador --portfolio <lista> [--semente n] [--nucleos n] [--corrotinas]
+static int executar_portfolio(int argc, char* argv[])
+{
+    unsigned long long semente = time(NULL);
+    int n_nucleos = 0;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--nucleos") == 0 && i + 1 < argc) {
+            n_nucleos = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--corrotinas") == 0) {
+            deterministico_definir_corrotinas(TRUE);
+        } else {
+            printf("Erro: opcao desconhecida %s\n", argv[i]);
+            return 1;
+        }
+    }
+    relogio_iniciar();
+    return portfolio_executar(argv[2], n_nucleos, semente) ? 0 : 1;
+}
+
+
+/* === DIMENSIONAMENTO === */
+// Lista "a,b,c" de ate DIMENSIONAMENTO_MAX_OPCOES valores positivos. Retorna quantos leu, ou -1.
+static int ler_opcoes(const char* texto, double* valores)
+{
+    int n = 0;
+    const char* p = texto;
+    while (*p != '\0') {
+        char* fim;
+        double v = strtod(p, &fim);
+        if (fim == p || v <= 0 || n == DIMENSIONAMENTO_MAX_OPCOES || (*fim != ',' && *fim != '\0'))
+            return -1;
+        valores[n++] = v;
+        p = *fim == ',' ? fim + 1 : fim;
+    }
+    return n > 0 ? n : -1;
+}
+
+// simulador --dimensionar <arquivo.ini> --p95 <s> [--semente n] [--nucleos n] [--replicas n]
+//           [--max-elevadores n] [--velocidades a,b] [--capacidades a,b] [--corrotinas]
+static int executar_dimensionamento(int argc, char* argv[])
+{
+    ParametrosDimensionamento p;
+    memset(&p, 0, sizeof(p));
+    p.max_replicas = 30;
+    p.semente = time(NULL);
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--p95") == 0 && i + 1 < argc) {
+            p.alvo_p95 = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            p.semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--nucleos") == 0 && i + 1 < argc) {
+            p.n_nucleos = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--replicas") == 0 && i + 1 < argc) {
+            p.max_replicas = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-elevadores") == 0 && i + 1 < argc) {
+            p.max_elevadores = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--velocidades") == 0 && i + 1 < argc) {
+            p.n_velocidades = ler_opcoes(argv[++i], p.velocidades);
+            if (p.n_velocidades < 0) {
+                printf("Erro: --velocidades espera ate %d valores positivos separados por virgula\n", DIMENSIONAMENTO_MAX_OPCOES);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--capacidades") == 0 && i + 1 < argc) {
+            double valores[DIMENSIONAMENTO_MAX_OPCOES];
+            p.n_capacidades = ler_opcoes(argv[++i], valores);
+            if (p.n_capacidades < 0) {
+                printf("Erro: --capacidades espera ate %d valores positivos separados por virgula\n", DIMENSIONAMENTO_MAX_OPCOES);
+                return 1;
+            }
+            for (int j = 0; j < p.n_capacidades; j++)
+                p.capacidades[j] = (int)valores[j];
+        } else if (strcmp(argv[i], "--corrotinas") == 0) {
+            deterministico_definir_corrotinas(TRUE);
+        } else {
+            printf("Erro: opcao desconhecida %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (p.alvo_p95 <= 0 || p.max_replicas < 1) {
+        printf("Erro: --dimensionar requer --p95 <s> positivo e pelo menos 1 replica\n");
+        return 1;
+    }
+    relogio_iniciar();
+    return dimensionamento_executar(argv[2], &p) ? 0 : 1;
+}
+
+
+/* === OTIMIZADOR === */
+// simulador --otimizar <arquivo.ini> [--objetivo media|p95] [--geracoes n] [--populacao n]
+//           [--elite n] [--replicas n] [--semente n] [--nucleos n]
+static int executar_otimizador(int argc, char* argv[])
+{
+    ParametrosOtimizador p = {OBJETIVO_MEDIA, 20, 16, 0, 8, 0, time(NULL)};
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--objetivo") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "media") == 0) {
+                p.objetivo = OBJETIVO_MEDIA;
+            } else if (strcmp(argv[i], "p95") == 0) {
+                p.objetivo = OBJETIVO_P95;
+            } else {
+                printf("Erro: objetivo deve ser media ou p95\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--geracoes") == 0 && i + 1 < argc) {
+            p.geracoes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--populacao") == 0 && i + 1 < argc) {
+            p.populacao = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--elite") == 0 && i + 1 < argc) {
+            p.elite = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--replicas") == 0 && i + 1 < argc) {
+            p.replicas = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            p.semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--nucleos") == 0 && i + 1 < argc) {
+            p.n_nucleos = atoi(argv[++i]);
+        } else {
+            printf("Erro: opcao desconhecida %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (p.elite == 0)
+        p.elite = p.populacao / 4 > 1 ? p.populacao / 4 : 1;
+    if (p.geracoes < 1 || p.populacao < 2 || p.elite < 1 || p.elite > p.populacao || p.replicas < 1) {
+        printf("Erro: --otimizar requer geracoes >= 1, populacao >= 2, 1 <= elite <= populacao e replicas >= 1\n");
+        return 1;
+    }
+    relogio_iniciar();
+    return otimizador_executar(argv[2], &p) ? 0 : 1;
+}
+
+
+/* === LOTE === */
+// simulador --lote <arquivo.ini> <n_replicas> [--semente n] [--passo s] [--comparar]
+static int executar_lote(int argc, char* argv[])
+{
+    unsigned long long semente = time(NULL);
+    double passo = 0.1;
+    int comparar = FALSE;
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--passo") == 0 && i + 1 < argc) {
+            passo = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--comparar") == 0) {
+            comparar = TRUE;
+        } else {
+            printf("Erro: opcao desconhecida %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    Predio predio;
+    if (!config_carregar(argv[2], &predio))
+        return 1;
+    relogio_iniciar();
+    int ok = lote_executar(&predio, atoi(argv[3]), semente, passo, comparar);
+    config_liberar(&predio);
+    return ok ? 0 : 1;
+}
+
+
 /* === FUNCAO PRINCIPAL === */
 int main (int argc, char* argv[]) 
 {
+    if (argc >= 3 && strcmp(argv[1], "--portfolio") == 0)
+        return executar_portfolio(argc, argv);
+    if (argc >= 3 && strcmp(argv[1], "--dimensionar") == 0)
+        return executar_dimensionamento(argc, argv);
+    if (argc >= 3 && strcmp(argv[1], "--otimizar") == 0)
+        return executar_otimizador(argc, argv);
+    if (argc >= 4 && strcmp(argv[1], "--lote") == 0)
+        return executar_lote(argc, argv);
+
     // Validação dos argumentos de linha de comando
-    if (argc != 4) {
-        printf("Erro: chamada do programa deve estar no formato %s <n_andares> <n_elevadores> <n_chamadas>\n", argv[0]);
-        printf("Exemplo: %s 10 3 20\n\n", argv[0]);
+    int usa_config = argc >= 3 && strcmp(argv[1], "--config") == 0;
+    if (!usa_config && argc < 4) {
+        printf("Erro: chamada do programa deve estar no formato %s <n_andares> <n_elevadores> <n_chamadas> [opcoes]\n", argv[0]);
+        printf("                                         ou %s --config <arquivo.ini> [opcoes]\n", argv[0]);
+        printf("                                         ou %s --portfolio <lista> [--semente n] [--nucleos n] [--corrotinas]\n", argv[0]);
+        printf("                                         ou %s --dimensionar <arquivo.ini> --p95 <s> [--semente n] [--nucleos n]\n", argv[0]);
+        printf("                                              [--replicas n] [--max-elevadores n] [--velocidades a,b] [--capacidades a,b]\n");
+        printf("                                         ou %s --otimizar <arquivo.ini> [--objetivo media|p95] [--geracoes n]\n", argv[0]);
+        printf("                                              [--populacao n] [--elite n] [--replicas n] [--semente n] [--nucleos n]\n");
+        printf("                                         ou %s --lote <arquivo.ini> <n_replicas> [--semente n] [--passo s] [--comparar]\n", argv[0]);
+        printf("Exemplo: %s 10 3 20\n", argv[0]);
+        printf("Opcoes:\n");
+        printf("  --sem-estacionamento   nao reposiciona elevadores ociosos\n");
+        printf("  --zonas <n>            divide andares e elevadores em n zonas (terreo como transferencia)\n");
+        printf("  --semente <n>          semente dos geradores aleatorios\n");
+        printf("  --checkpoint <arq> <t> grava o estado completo da simulacao no instante t (s)\n");
+        printf("  --restaurar <arq>      continua a simulacao a partir de um checkpoint\n");
+        printf("  --trace <arq.json>     exporta a linha do tempo no formato trace-event (Chrome/Perfetto)\n");
+        printf("  --metricas <socket>    serve metricas ao vivo (formato Prometheus) num socket Unix\n");
+        printf("  --servico <socket>     aceita chamadas externas num socket Unix e responde elevador e ETA\n");
+        printf("  --sem-geradores        nao gera chamadas internas (com --servico, roda ate ser interrompido)\n");
+        printf("  --compartilhar </nome> publica o estado da frota num segmento de memoria compartilhada\n");
+        printf("  --painel <quadros/s>   exibe o painel da frota no terminal no lugar do log\n");
+        printf("  --escala-tempo <x>     roda o relogio da simulacao x vezes mais rapido que o tempo real\n");
+        printf("  --despachantes <n>     scheduler paralelo: n threads com faixas de andares e roubo de chamadas\n");
+        printf("  --deterministico       executa numa unica thread com relogio virtual e imprime o digest do log\n");
+        printf("  --esperado <digest>    (com --deterministico) falha se o digest for diferente\n");
+        printf("  --estresse             roda sem esperas e confere que cada chamada foi entregue uma unica vez\n");
+        printf("  --teste-escala         (motor deterministico) mede chamadas/s, RSS e alocacoes em regime\n");
+        printf("  --corrotinas           (motor deterministico) cada elevador roda como corrotina, sem limite de frota\n");
+        printf("  --antecipacao <s>      (motor deterministico) despacho por rollouts com horizonte de s segundos\n");
+        printf("  --nucleos <n>          threads dos rollouts da antecipacao (padrao: todos os nucleos)\n");
+        printf("  --pesos <e,d,c,p,r>    (motor deterministico) despacho por custo: pesos de ETA, distancia, carga,\n");
+        printf("                         paradas e direcao (padrao 1,0,0,0,0: menor ETA)\n\n");
         return 1;
     }
 
-    n_andares = atoi(argv[1]);
-    n_elevadores = atoi(argv[2]);
-    n_chamadas = atoi(argv[3]);
+    // Monta o modelo do edificio uma unica vez, antes de criar as threads
+    if (usa_config) {
+        if (!config_carregar(argv[2], &predio))
+            return 1;
+    } else {
+        int andares = atoi(argv[1]);
+        int elevs = atoi(argv[2]);
+        int chamadas = atoi(argv[3]);
+        if (andares < 2) {
+            printf("Erro: número de andares deve ser pelo menos 2\n");
+            return 1;
+        }
+        if (elevs < 2) {
+            printf("Erro: número de elevadores deve ser pelo menos 2\n");
+            return 1;
+        }
+        if (!config_predio_padrao(&predio, andares, elevs, chamadas))
+            return 1;
+    }
+
+    // Opcoes da linha de comando sobrepoem a politica do arquivo
+    unsigned long long semente = time(NULL);
+    double escala_tempo = 1;
+    for (int i = usa_config ? 3 : 4; i < argc; i++) {
+        if (strcmp(argv[i], "--sem-estacionamento") == 0) {
+            predio.politica.estacionamento = FALSE;
+        } else if (strcmp(argv[i], "--zonas") == 0 && i + 1 < argc) {
+            predio.politica.zonas_uniformes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 2 < argc) {
+            arquivo_checkpoint = argv[++i];
+            instante_checkpoint = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--restaurar") == 0 && i + 1 < argc) {
+            arquivo_restauracao = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            arquivo_trace = argv[++i];
+        } else if (strcmp(argv[i], "--metricas") == 0 && i + 1 < argc) {
+            socket_metricas = argv[++i];
+        } else if (strcmp(argv[i], "--servico") == 0 && i + 1 < argc) {
+            socket_servico = argv[++i];
+        } else if (strcmp(argv[i], "--sem-geradores") == 0) {
+            geradores_internos = FALSE;
+        } else if (strcmp(argv[i], "--compartilhar") == 0 && i + 1 < argc) {
+            nome_compartilhado = argv[++i];
+        } else if (strcmp(argv[i], "--deterministico") == 0) {
+            modo_deterministico = TRUE;
+        } else if (strcmp(argv[i], "--corrotinas") == 0) {
+            modo_deterministico = TRUE;
+            deterministico_definir_corrotinas(TRUE);
+        } else if (strcmp(argv[i], "--antecipacao") == 0 && i + 1 < argc) {
+            modo_deterministico = TRUE;
+            deterministico_definir_antecipacao(atof(argv[++i]));
+        } else if (strcmp(argv[i], "--nucleos") == 0 && i + 1 < argc) {
+            n_nucleos = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--pesos") == 0 && i + 1 < argc) {
+            PesosDespacho pesos;
+            if (sscanf(argv[++i], "%lf,%lf,%lf,%lf,%lf", &pesos.eta, &pesos.distancia, &pesos.carga,
+                       &pesos.paradas, &pesos.direcao) != 5) {
+                printf("Erro: --pesos espera eta,distancia,carga,paradas,direcao\n");
+                return 1;
+            }
+            modo_deterministico = TRUE;
+            deterministico_definir_pesos(&pesos);
+        } else if (strcmp(argv[i], "--teste-escala") == 0) {
+            modo_deterministico = TRUE;
+            teste_escala = TRUE;
+        } else if (strcmp(argv[i], "--estresse") == 0) {
+            modo_estresse = TRUE;
+        } else if (strcmp(argv[i], "--esperado") == 0 && i + 1 < argc) {
+            digest_esperado = argv[++i];
+        } else if (strcmp(argv[i], "--despachantes") == 0 && i + 1 < argc) {
+            n_despachantes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--escala-tempo") == 0 && i + 1 < argc) {
+            escala_tempo = atof(argv[++i]);
+            if (escala_tempo <= 0) {
+                printf("Erro: escala de tempo deve ser positiva\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--painel") == 0 && i + 1 < argc) {
+            quadros_painel = atof(argv[++i]);
+            if (quadros_painel <= 0) {
+                printf("Erro: taxa de quadros do painel deve ser positiva\n");
+                return 1;
+            }
+        } else {
+            printf("Erro: opcao desconhecida %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    n_andares = predio.n_andares;
+    n_elevadores = predio.n_elevadores;
+    n_chamadas = predio.n_chamadas;
 
-    if (n_andares < 2 || n_andares > MAX_ANDARES) {
-        printf("Erro: número de andares deve estar entre 2 e %d\n", MAX_ANDARES);
+    // Uma thread por carro so no motor com threads; o relogio virtual nao tem esse teto
+    if (!modo_deterministico && n_elevadores > MAX_ELEVADORES) {
+        printf("Erro: número de elevadores deve ser no máximo %d\n", MAX_ELEVADORES);
+        return 1;
+    }
+    // O limite so protege a duracao da simulacao em tempo real
+    int limite_chamadas = modo_estresse || modo_deterministico ? INT_MAX : MAX_CHAMADAS;
+    if (n_chamadas < 2 || n_chamadas > limite_chamadas) {
+        if (limite_chamadas == INT_MAX)
+            printf("Erro: número de chamadas deve ser pelo menos 2\n");
+        else
+            printf("Erro: número de chamadas deve estar entre 2 e %d\n", limite_chamadas);
         return 1;
     }
-    if (n_elevadores < 2 || n_elevadores > MAX_ELEVADORES) {
-        printf("Erro: número de elevadores deve estar entre 2 e %d\n", MAX_ELEVADORES);
+    if (n_despachantes < 1 || n_despachantes > n_andares) {
+        printf("Erro: número de despachantes deve estar entre 1 e %d\n", n_andares);
+        return 1;
+    }
+    if (predio.politica.zonas_uniformes < 1) {
+        printf("Erro: número de zonas deve ser pelo menos 1\n");
+        return 1;
+    }
+
+    if (escala_tempo != 1 && (modo_estresse || modo_deterministico)) {
+        printf("Erro: --escala-tempo so se aplica ao motor com threads em tempo real\n");
         return 1;
     }
-    if (n_chamadas < 2 || n_chamadas > MAX_CHAMADAS) {
-        printf("Erro: número de chamadas deve estar entre 2 e %d\n", MAX_CHAMADAS);
+
+    // Inicializa relogio da simulacao (no estresse, sem esperas) e cache de ETA da frota
+    relogio_definir_escala(modo_estresse ? 0 : 1 / escala_tempo);
+    relogio_iniciar();
+    ModeloViagem modelos[n_elevadores];
+    for (int i = 0; i < n_elevadores; i++) {
+        modelos[i].velocidade = predio.elevadores[i].velocidade;
+        modelos[i].tempo_porta = predio.elevadores[i].tempo_porta;
+    }
+    eta_iniciar(n_elevadores, modelos, predio.cota);
+    demanda_iniciar(n_andares);
+    if (!metricas_iniciar(n_elevadores, n_andares))
+        return 1;
+
+    // Zonas explicitas do arquivo ou divisao uniforme
+    zonas_iniciar(n_elevadores);
+    if (predio.n_zonas > 0) {
+        for (int z = 0; z < predio.n_zonas; z++) {
+            const ConfigZona* cz = &predio.zonas[z];
+            if (zonas_adicionar(cz->andar_min, cz->andar_max, cz->andar_transferencia,
+                                &predio.ids_zonas[cz->inicio_ids], cz->n_ids) < 0) {
+                printf("Erro: nao foi possivel registrar a zona %d\n", z);
+                return 1;
+            }
+        }
+    } else {
+        zonas_configurar_uniforme(n_andares, n_elevadores, predio.politica.zonas_uniformes);
+    }
+
+    // Motor deterministico: mesmo modelo, sem threads nem relogio real
+    if (modo_deterministico) {
+        if (!antecipacao_iniciar(n_nucleos > 0 ? n_nucleos : (int)sysconf(_SC_NPROCESSORS_ONLN)))
+            return 1;
+        int ok = teste_escala ? deterministico_teste_escala(&predio, semente)
+                              : deterministico_executar(&predio, semente, TRUE, digest_esperado);
+        deterministico_finalizar();
+        antecipacao_finalizar();
+        eta_finalizar();
+        demanda_finalizar();
+        zonas_finalizar();
+        config_liberar(&predio);
+        return ok ? 0 : 1;
+    }
+
+    elevadores = calloc(n_elevadores, sizeof(Elevador));
+    produtores = calloc(n_andares, sizeof(ProdutorAndar));
+    despachantes = calloc(n_despachantes, sizeof(Despachante));
+    if (elevadores == NULL || produtores == NULL || despachantes == NULL) {
+        printf("Erro: sem memoria para os elevadores\n");
         return 1;
     }
 
-    // Incializa semente aleatoria
-    srand(time(NULL));
+    // So com o servico, a simulacao roda ate SIGINT/SIGTERM e encerra normalmente: os sinais
+    // ficam bloqueados em todas as threads (herdam a mascara) e main os recebe com sigwait
+    sigset_t sinais_encerramento;
+    sigemptyset(&sinais_encerramento);
+    sigaddset(&sinais_encerramento, SIGINT);
+    sigaddset(&sinais_encerramento, SIGTERM);
+    if (!geradores_internos && socket_servico != NULL)
+        pthread_sigmask(SIG_BLOCK, &sinais_encerramento, NULL);
+
+    // Incializa semente aleatoria (um fluxo independente por andar)
+    for (int i = 0; i < n_andares; i++) {
+        aleatorio_semear(&produtores[i].rng, semente, i);
+        produtores[i].proxima_chamada = 0;
+    }
 
     // Inicializa threads e arrays
     pthread_t threads_andares[n_andares];
+    int ids_andares[n_andares];
     pthread_t threads_elevadores[n_elevadores];
-    pthread_t thread_scheduler;
+    pthread_t thread_estacionamento;
+    pthread_t thread_checkpoint;
 
     // Inicializa buffer de chamadas
     buffer.inicio = 0;
     buffer.fim = 0;
     buffer.contador = 0;
 
-    // Inicializa estruturas de sincronizacao do buffer
-    pthread_mutex_init(&mutex_buffer, NULL);
-    sem_init(&sem_buffer_ocupou, 0, 0);
-    sem_init(&sem_buffer_liberou, 0, TAM_BUFFER);
+    // Registra os pontos de sincronizacao para o relatorio de disputa
+    sinc_registrar(&est_mutex_buffer, "mutex_buffer");
+    sinc_registrar(&est_mutex_chamada, "mutex_chamada");
+    sinc_registrar(&est_mutex_pendentes, "mutex_pendentes");
+    sinc_registrar(&est_trava_estado, "trava_estado");
+    sinc_registrar(&est_sem_buffer_ocupou, "sem_buffer_ocupou");
+    sinc_registrar(&est_sem_buffer_liberou, "sem_buffer_liberou");
 
-    // Cria threads dos elevadores
+    // Inicializa estado dos elevadores
     for (int i = 0; i < n_elevadores; i++) {
+        char nome[32];
+        snprintf(nome, sizeof(nome), "mutex_fila[%d]", i);
+        sinc_registrar(&elevadores[i].est_mutex_fila, nome);
+        snprintf(nome, sizeof(nome), "sem_elevador_ocupou[%d]", i);
+        sinc_registrar(&elevadores[i].est_sem_ocupou, nome);
+
         elevadores[i].id = i;
         elevadores[i].andar_atual = 0;
         elevadores[i].chamadas_atendidas = 0;
         elevadores[i].ocupado = 0;
-        sem_init(&elevadores[i].sem_elevador_ocupou, 0, 0);
+        elevadores[i].fila_inicio = 0;
+        elevadores[i].fila_contador = 0;
+        elevadores[i].limite_fila = predio.elevadores[i].capacidade < TAM_FILA_ELEVADOR
+                                        ? predio.elevadores[i].capacidade : TAM_FILA_ELEVADOR;
+        pthread_mutex_init(&elevadores[i].mutex_fila, NULL);
+    }
+
+    // Continua de um checkpoint (relogio, frota, filas, geradores e demanda)
+    if (arquivo_restauracao != NULL && !restaurar_estado(arquivo_restauracao))
+        return 1;
+
+    // Publica o estado inicial e abre o servidor de metricas
+    metricas_backlog(buffer.contador);
+    for (int k = 0; k < buffer.contador; k++)
+        metricas_andar_aguardando(buffer.chamadas[(buffer.inicio + k) % TAM_BUFFER].origem, 1);
+    for (int i = 0; i < n_elevadores; i++) {
+        metricas_elevador_andar(i, elevadores[i].andar_atual);
+        metricas_elevador_fila(i, elevadores[i].fila_contador, elevadores[i].ocupado);
+        for (int k = 0; k < elevadores[i].fila_contador; k++)
+            if (!elevadores[i].fila[k].reposicionamento)
+                metricas_andar_aguardando(elevadores[i].fila[k].origem, 1);
+    }
+    if (socket_metricas != NULL && !metricas_servir(socket_metricas))
+        return 1;
+
+    // Segmento compartilhado: epoca ja ajustada pela restauracao
+    if (nome_compartilhado != NULL) {
+        if (!compartilhado_iniciar(nome_compartilhado, n_andares, n_elevadores, relogio_epoca_ns(), relogio_escala()))
+            return 1;
+        for (int i = 0; i < n_elevadores; i++) {
+            elevadores[i].destino_trecho = elevadores[i].andar_atual;
+            publicar_estado(&elevadores[i]);
+        }
+    }
+
+    // Abre o trace e nomeia uma trilha por thread (elevadores primeiro no visualizador)
+    if (arquivo_trace != NULL) {
+        if (!trace_iniciar(arquivo_trace))
+            return 1;
+        char nome[32];
+        trace_nomear_trilha(TRILHA_SCHEDULER, "Scheduler", 0);
+        for (int i = 0; i < n_elevadores; i++) {
+            snprintf(nome, sizeof(nome), "Elevador %d", i);
+            trace_nomear_trilha(TRILHA_ELEVADOR(i), nome, 1 + i);
+        }
+        trace_nomear_trilha(TRILHA_ESTACIONAMENTO, "Estacionamento", 1 + n_elevadores);
+        trace_nomear_trilha(TRILHA_CHECKPOINT, "Checkpoint", 2 + n_elevadores);
+        trace_nomear_trilha(TRILHA_SERVICO, "Servico", 3 + n_elevadores);
+        for (int a = 0; a < n_andares; a++) {
+            snprintf(nome, sizeof(nome), "Andar %d", a);
+            trace_nomear_trilha(TRILHA_ANDAR(a), nome, 4 + n_elevadores + a);
+        }
+    }
+
+    // Painel no terminal: a partir daqui o log vai para /dev/null
+    if (quadros_painel > 0 && !painel_iniciar(n_andares, n_elevadores, quadros_painel))
+        return 1;
+
+    // Modo de estresse: vigia de progresso (o relogio ja corre sem esperas)
+    if (modo_estresse) {
+        if (!estresse_iniciar(n_chamadas, despejar_estado))
+            return 1;
+    }
+
+    // Inicializa estruturas de sincronizacao do buffer (contagens refletem o estado inicial)
+    pthread_mutex_init(&mutex_buffer, NULL);
+    pthread_mutex_init(&mutex_chamada, NULL);
+    pthread_mutex_init(&mutex_pendentes, NULL);
+    pthread_cond_init(&cond_drenado, NULL);
+    pthread_condattr_t atributos_cond;
+    pthread_condattr_init(&atributos_cond);
+    pthread_condattr_setclock(&atributos_cond, CLOCK_MONOTONIC);
+    pthread_cond_init(&cond_encerramento, &atributos_cond);
+    pthread_condattr_destroy(&atributos_cond);
+    sem_init(&sem_buffer_ocupou, 0, buffer.contador);
+    sem_init(&sem_buffer_liberou, 0, TAM_BUFFER - buffer.contador);
+
+    // Cria threads dos elevadores
+    for (int i = 0; i < n_elevadores; i++) {
+        sem_init(&elevadores[i].sem_elevador_ocupou, 0, elevadores[i].fila_contador);
         pthread_create(&threads_elevadores[i], NULL, funcao_elevador, &elevadores[i]);
     }
 
-    // Cria threads dos andares
-    for (int i = 0; i < n_andares; i++) {
-        int* andar = malloc(sizeof(int));
-        *andar = i;
-        pthread_create(&threads_andares[i], NULL, funcao_andar, andar);
+    // Cria threads dos andares (ids vivem em main ate os joins)
+    for (int i = 0; i < n_andares && geradores_internos; i++) {
+        ids_andares[i] = i;
+        pthread_create(&threads_andares[i], NULL, funcao_andar, &ids_andares[i]);
     }
 
-    // Cria thread scheduler
-    pthread_create(&thread_scheduler, NULL, funcao_scheduler, NULL);
+    // Cria thread scheduler, ou um despachante por faixa contigua de andares
+    if (n_despachantes == 1) {
+        pthread_create(&despachantes[0].thread, NULL, funcao_scheduler, NULL);
+    } else {
+        for (int k = 0; k < n_despachantes; k++) {
+            despachantes[k].andar_min = k * n_andares / n_despachantes;
+            despachantes[k].andar_max = (k + 1) * n_andares / n_despachantes - 1;
+            pthread_create(&despachantes[k].thread, NULL, funcao_scheduler, &despachantes[k]);
+        }
+    }
 
-    // Aguarda todas as threads de andares terminarem
-    for (int i = 0; i < n_andares; i++) {
+    // Cria thread da politica de estacionamento
+    if (predio.politica.estacionamento)
+        pthread_create(&thread_estacionamento, NULL, funcao_estacionamento, NULL);
+
+    // Cria thread de checkpoint (acordada pelo encerramento se a simulacao terminar antes)
+    if (arquivo_checkpoint != NULL)
+        pthread_create(&thread_checkpoint, NULL, funcao_checkpoint, NULL);
+
+    // Aceita chamadas externas depois que o scheduler esta de pe
+    if (socket_servico != NULL && !injecao_iniciar(socket_servico, n_andares, injetar_chamadas))
+        return 1;
+
+    // Aguarda todas as threads de andares terminarem; so com o servico, ate SIGINT/SIGTERM
+    for (int i = 0; i < n_andares && geradores_internos; i++) {
         pthread_join(threads_andares[i], NULL);
     }
-    printf("Todas as threads de andares foram encerradas.\n");
-    printf("Total de %d chamadas foram geradas.\n\n", chamadas_geradas);
+    if (!geradores_internos && socket_servico != NULL) {
+        int sinal;
+        sigwait(&sinais_encerramento, &sinal);
+        printf("[Servico] Sinal %d recebido: encerrando\n", sinal);
+    } else {
+        printf("Todas as threads de andares foram encerradas.\n");
+        printf("Total de %d chamadas foram geradas.\n\n", chamadas_geradas);
+    }
+
+    // Encerramento em etapas, sem perder chamadas:
+    // 1. fecha a entrada de pedidos externos e espera os passageiros restantes sairem
+    sinc_travar(&mutex_pendentes, &est_mutex_pendentes, -1);
+    aceitando_externas = FALSE;
+    while (chamadas_pendentes > 0)
+        pthread_cond_wait(&cond_drenado, &mutex_pendentes);
+    pthread_mutex_unlock(&mutex_pendentes);
 
-    // Aguarda todas as threads de elevadores terminarem
+    // 2. encerra a politica de estacionamento e o checkpoint pendente
+    pthread_rwlock_wrlock(&trava_estado);
+    __atomic_store_n(&simulacao_ativa, FALSE, __ATOMIC_RELEASE);
+    pthread_rwlock_unlock(&trava_estado);
+    pthread_mutex_lock(&mutex_encerramento);
+    pthread_cond_broadcast(&cond_encerramento);
+    pthread_mutex_unlock(&mutex_encerramento);
+    if (predio.politica.estacionamento)
+        pthread_join(thread_estacionamento, NULL);
+    if (arquivo_checkpoint != NULL)
+        pthread_join(thread_checkpoint, NULL);
+
+    // 3. fecha o buffer: uma ficha extra por despachante, cada um sai com o buffer vazio
+    sinc_travar(&mutex_buffer, &est_mutex_buffer, -1);
+    buffer_fechado = TRUE;
+    pthread_mutex_unlock(&mutex_buffer);
+    for (int k = 0; k < n_despachantes; k++)
+        sem_post(&sem_buffer_ocupou);
+    for (int k = 0; k < n_despachantes; k++)
+        pthread_join(despachantes[k].thread, NULL);
+
+    // 4. fecha as filas: cada elevador conclui o que ja tinha (reposicionamentos) e sai
+    for (int i = 0; i < n_elevadores; i++) {
+        sinc_travar(&elevadores[i].mutex_fila, &elevadores[i].est_mutex_fila, -1);
+        elevadores[i].encerrar = TRUE;
+        pthread_mutex_unlock(&elevadores[i].mutex_fila);
+        sem_post(&elevadores[i].sem_elevador_ocupou);
+    }
     for (int i = 0; i < n_elevadores; i++) {
         pthread_join(threads_elevadores[i], NULL);
     }
     printf("Todas as threads de elevadores foram encerradas.\n");
 
+    // 5. sem threads da simulacao: encerra os servicos auxiliares
+    injecao_finalizar();
+    painel_finalizar();
+    trace_finalizar();
+    metricas_finalizar();
+    compartilhado_finalizar();
+
+    // Confere as invariantes antes de liberar o estado
+    int invariantes_ok = !modo_estresse || estresse_verificar(id_chamada);
+
     // Libera os recursos de sincronização
     pthread_mutex_destroy(&mutex_buffer);
     pthread_mutex_destroy(&mutex_chamada);
-    pthread_mutex_destroy(&mutex_chamadas_geradas);
+    pthread_mutex_destroy(&mutex_pendentes);
+    pthread_cond_destroy(&cond_drenado);
+    pthread_cond_destroy(&cond_encerramento);
     sem_destroy(&sem_buffer_ocupou);
     sem_destroy(&sem_buffer_liberou);
+    for (int i = 0; i < n_elevadores; i++) {
+        pthread_mutex_destroy(&elevadores[i].mutex_fila);
+    }
+    eta_finalizar();
+    demanda_finalizar();
+    zonas_finalizar();
 
     // Estatísticas finais
     printf("\n=== SIMULAÇÃO FINALIZADA ===\n");
-    printf("Todas as %d chamadas foram atendidas com sucesso.\n", n_chamadas);
+    printf("Chamadas concluidas: %d (descartadas: %d)\n", chamadas_concluidas, chamadas_descartadas);
     printf("Posição final dos elevadores:\n");
     for (int i = 0; i < n_elevadores; i++) {
         printf("- Elevador %d: andar %d\n", elevadores[i].id, elevadores[i].andar_atual);
         printf("- Elevador %d: chamadas atendidas: %d\n", elevadores[i].id, elevadores[i].chamadas_atendidas);
     }
+    for (int k = 0; k < n_despachantes && n_despachantes > 1; k++) {
+        const Despachante* d = &despachantes[k];
+        printf("- Despachante %d (andares %d-%d): %ld proprias, %ld roubadas, %ld conflitos\n", k,
+               d->andar_min, d->andar_max, d->proprias, d->roubadas, d->conflitos);
+    }
 
-    return 0;
+    if (!modo_estresse) {
+        long esperas, vencidas, atrasadas;
+        double atraso_max;
+        relogio_atrasos(&esperas, &vencidas, &atrasadas, &atraso_max);
+        printf("Relogio: escala %gx, %ld esperas; %ld com o prazo ja vencido, %ld acordaram mais de 1 ms "
+               "depois do prazo (maior atraso %.1f ms)\n", escala_tempo, esperas, vencidas, atrasadas,
+               atraso_max * 1000);
+    }
+
+    sinc_relatorio();
+
+    free(elevadores);
+    free(produtores);
+    free(despachantes);
+    config_liberar(&predio);
+    return invariantes_ok ? 0 : 1;
     
     
 }
\ No newline at end of file
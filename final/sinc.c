@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <string.h>
+#include "sinc.h"
+
+
+/* === REGISTRO DOS PONTOS DE SINCRONIZACAO === */
+static EstatisticaSinc* registrados = NULL;
+static pthread_mutex_t mutex_registro = PTHREAD_MUTEX_INITIALIZER;
+
+void sinc_registrar(EstatisticaSinc* e, const char* nome)
+{
+    memset(e, 0, sizeof(*e));
+    snprintf(e->nome, sizeof(e->nome), "%s", nome);
+    snprintf(e->rotulo_trace, sizeof(e->rotulo_trace), "espera %s", nome);
+
+    pthread_mutex_lock(&mutex_registro);
+    e->proxima = registrados;
+    registrados = e;
+    pthread_mutex_unlock(&mutex_registro);
+}
+
+
+/* === CONTABILIZACAO === */
+// Varias threads podem adquirir o mesmo ponto ao mesmo tempo (leitores, semaforos):
+// contadores atualizados com atomicos relaxados
+void sinc_contabilizar(EstatisticaSinc* e)
+{
+    __atomic_fetch_add(&e->aquisicoes, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&e->histograma[0], 1, __ATOMIC_RELAXED);
+}
+
+#ifdef INSTRUMENTAR_SINC
+static int balde_espera(uint64_t ns)
+{
+    uint64_t us = ns / 1000;
+    int k = 0;
+    while (us > 0 && k < SINC_BALDES - 1) {
+        us >>= 1;
+        k++;
+    }
+    return k;
+}
+
+void sinc_disputa(EstatisticaSinc* e, int trilha, double inicio)
+{
+    // Espera em tempo real: a escala da simulacao nao se aplica a disputa por travas
+    double espera = relogio_real() - inicio;
+    uint64_t ns = (uint64_t)(espera * 1e9);
+    __atomic_fetch_add(&e->aquisicoes, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&e->disputadas, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&e->espera_total_ns, ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&e->histograma[balde_espera(ns)], 1, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&e->espera_max_ns, __ATOMIC_RELAXED);
+    while (ns > max && !__atomic_compare_exchange_n(&e->espera_max_ns, &max, ns, 1,
+                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+
+    // No trace o span termina no instante da simulacao da aquisicao, com a duracao real
+    if (trace_ativo && trilha >= 0) {
+        double fim = relogio_agora();
+        trace_span(trilha, e->rotulo_trace, fim - espera, fim, NULL);
+    }
+}
+#endif
+
+
+/* === RELATORIO === */
+#ifdef INSTRUMENTAR_SINC
+// Limite superior (us) do balde em que cai o percentil p do histograma
+static double percentil_us(const EstatisticaSinc* e, double p)
+{
+    uint64_t alvo = (uint64_t)(p * e->aquisicoes);
+    uint64_t acumulado = 0;
+    for (int k = 0; k < SINC_BALDES; k++) {
+        acumulado += e->histograma[k];
+        if (acumulado > alvo)
+            return k == 0 ? 1.0 : (double)(1ULL << k);
+    }
+    return (double)(1ULL << (SINC_BALDES - 1));
+}
+#endif
+
+void sinc_relatorio(void)
+{
+#ifdef INSTRUMENTAR_SINC
+    printf("\n=== DISPUTA POR SINCRONIZACAO ===\n");
+    printf("%-26s %10s %10s %7s %12s %10s %10s %10s %12s\n", "ponto", "aquisicoes", "disputadas", "%",
+           "espera (ms)", "media (us)", "p50 (us)", "p99 (us)", "max (ms)");
+
+    pthread_mutex_lock(&mutex_registro);
+    for (EstatisticaSinc* e = registrados; e != NULL; e = e->proxima) {
+        if (e->aquisicoes == 0)
+            continue;
+        double media_us = e->disputadas > 0 ? e->espera_total_ns / 1e3 / e->disputadas : 0;
+        printf("%-26s %10llu %10llu %6.1f%% %12.3f %10.1f %10.0f %10.0f %12.3f\n", e->nome,
+               (unsigned long long)e->aquisicoes, (unsigned long long)e->disputadas,
+               100.0 * e->disputadas / e->aquisicoes, e->espera_total_ns / 1e6, media_us,
+               percentil_us(e, 0.50), percentil_us(e, 0.99), e->espera_max_ns / 1e6);
+    }
+    pthread_mutex_unlock(&mutex_registro);
+    printf("(p50/p99: limite superior do balde do histograma, em potencias de 2)\n");
+#endif
+}
@@ -0,0 +1,75 @@
+#ifndef SINC_H
+#define SINC_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include "relogio.h"
+#include "trace.h"
+
+/* === PRIMITIVAS DE SINCRONIZACAO INSTRUMENTADAS === */
+// Compilando com -DINSTRUMENTAR_SINC, cada ponto de sincronizacao conta aquisicoes,
+// aquisicoes disputadas e um histograma do tempo de espera, e as esperas disputadas
+// viram spans no trace. Sem a flag, os wrappers se reduzem a chamada pthread/semaforo.
+#define SINC_BALDES 32      // Balde k: espera em [2^(k-1), 2^k) microssegundos
+
+typedef struct EstatisticaSinc
+{
+    char nome[32];
+    char rotulo_trace[40];      // "espera <nome>", usado nos spans do trace
+    uint64_t aquisicoes;
+    uint64_t disputadas;
+    uint64_t espera_total_ns;
+    uint64_t espera_max_ns;
+    uint64_t histograma[SINC_BALDES];
+    struct EstatisticaSinc* proxima;
+} EstatisticaSinc;
+
+// Registra o ponto de sincronizacao com o nome exibido no relatorio e no trace
+void sinc_registrar(EstatisticaSinc* e, const char* nome);
+
+// Tabela de disputa por ponto de sincronizacao (vazia sem -DINSTRUMENTAR_SINC)
+void sinc_relatorio(void);
+
+// Uso interno dos wrappers instrumentados
+void sinc_contabilizar(EstatisticaSinc* e);
+// inicio: relogio_real() antes de bloquear
+void sinc_disputa(EstatisticaSinc* e, int trilha, double inicio);
+
+#ifdef INSTRUMENTAR_SINC
+#define SINC_ADQUIRIR(tentar, bloquear, e, trilha)          \
+    do {                                                    \
+        if ((tentar) == 0) {                                \
+            sinc_contabilizar(e);                           \
+            return;                                         \
+        }                                                   \
+        double inicio_ = relogio_real();                    \
+        bloquear;                                           \
+        sinc_disputa((e), (trilha), inicio_);               \
+    } while (0)
+#else
+#define SINC_ADQUIRIR(tentar, bloquear, e, trilha) bloquear
+#endif
+
+// trilha: trilha do trace da thread chamadora; < 0 para esperas ociosas (sem span)
+static inline void sinc_travar(pthread_mutex_t* m, EstatisticaSinc* e, int trilha)
+{
+    SINC_ADQUIRIR(pthread_mutex_trylock(m), pthread_mutex_lock(m), e, trilha);
+}
+
+static inline void sinc_travar_leitura(pthread_rwlock_t* t, EstatisticaSinc* e, int trilha)
+{
+    SINC_ADQUIRIR(pthread_rwlock_tryrdlock(t), pthread_rwlock_rdlock(t), e, trilha);
+}
+
+static inline void sinc_travar_escrita(pthread_rwlock_t* t, EstatisticaSinc* e, int trilha)
+{
+    SINC_ADQUIRIR(pthread_rwlock_trywrlock(t), pthread_rwlock_wrlock(t), e, trilha);
+}
+
+static inline void sinc_esperar(sem_t* s, EstatisticaSinc* e, int trilha)
+{
+    SINC_ADQUIRIR(sem_trywait(s), while (sem_wait(s) != 0), e, trilha);
+}
+
+#endif
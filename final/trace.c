@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <pthread.h>
+#include "trace.h"
+
+#define TRUE 1
+#define FALSE 0
+
+
+/* === VARIAVEIS GLOBAIS === */
+int trace_ativo = FALSE;
+static FILE* arquivo_trace = NULL;
+static int primeiro_evento = TRUE;
+static pthread_mutex_t mutex_trace = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* === CICLO DE VIDA === */
+int trace_iniciar(const char* caminho)
+{
+    arquivo_trace = fopen(caminho, "w");
+    if (arquivo_trace == NULL) {
+        printf("Erro: nao foi possivel criar o trace %s\n", caminho);
+        return FALSE;
+    }
+    fprintf(arquivo_trace, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    primeiro_evento = TRUE;
+    trace_ativo = TRUE;
+    return TRUE;
+}
+
+void trace_finalizar(void)
+{
+    if (!trace_ativo)
+        return;
+    pthread_mutex_lock(&mutex_trace);
+    trace_ativo = FALSE;
+    fprintf(arquivo_trace, "\n]}\n");
+    fclose(arquivo_trace);
+    arquivo_trace = NULL;
+    pthread_mutex_unlock(&mutex_trace);
+}
+
+
+/* === EVENTOS === */
+// Chamar com mutex_trace adquirido
+static void separador(void)
+{
+    if (!primeiro_evento)
+        fprintf(arquivo_trace, ",\n");
+    primeiro_evento = FALSE;
+}
+
+void trace_nomear_trilha(int trilha, const char* nome, int ordem)
+{
+    if (!trace_ativo)
+        return;
+    pthread_mutex_lock(&mutex_trace);
+    separador();
+    fprintf(arquivo_trace, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+            trilha, nome);
+    fprintf(arquivo_trace, "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"sort_index\":%d}}",
+            trilha, ordem);
+    pthread_mutex_unlock(&mutex_trace);
+}
+
+void trace_span(int trilha, const char* nome, double inicio, double fim, const char* args_json)
+{
+    if (!trace_ativo)
+        return;
+    pthread_mutex_lock(&mutex_trace);
+    if (arquivo_trace != NULL) {
+        separador();
+        fprintf(arquivo_trace, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                nome, trilha, inicio * 1e6, (fim - inicio) * 1e6);
+        if (args_json != NULL)
+            fprintf(arquivo_trace, ",\"args\":%s", args_json);
+        fputc('}', arquivo_trace);
+    }
+    pthread_mutex_unlock(&mutex_trace);
+}
+
+void trace_instante(int trilha, const char* nome, double t, const char* args_json)
+{
+    if (!trace_ativo)
+        return;
+    pthread_mutex_lock(&mutex_trace);
+    if (arquivo_trace != NULL) {
+        separador();
+        fprintf(arquivo_trace, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f",
+                nome, trilha, t * 1e6);
+        if (args_json != NULL)
+            fprintf(arquivo_trace, ",\"args\":%s", args_json);
+        fputc('}', arquivo_trace);
+    }
+    pthread_mutex_unlock(&mutex_trace);
+}
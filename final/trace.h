@@ -0,0 +1,28 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/* === EXPORTACAO DE TRACE (formato trace-event do Chrome/Perfetto) === */
+// Trilhas (tid) de cada thread da simulacao
+#define TRILHA_SCHEDULER 1
+#define TRILHA_ESTACIONAMENTO 2
+#define TRILHA_CHECKPOINT 3
+#define TRILHA_SERVICO 4
+#define TRILHA_ELEVADOR(id) (100 + (id))
+#define TRILHA_ANDAR(andar) (100000 + (andar))
+
+// Verdadeiro enquanto houver arquivo de trace aberto; consultado antes de medir tempos
+extern int trace_ativo;
+
+int trace_iniciar(const char* caminho);
+void trace_finalizar(void);
+
+// Nome exibido para a trilha e posicao dela no visualizador
+void trace_nomear_trilha(int trilha, const char* nome, int ordem);
+
+// Intervalo [inicio, fim] (segundos de simulacao). args_json e um objeto JSON ou NULL.
+void trace_span(int trilha, const char* nome, double inicio, double fim, const char* args_json);
+
+// Evento instantaneo
+void trace_instante(int trilha, const char* nome, double t, const char* args_json);
+
+#endif
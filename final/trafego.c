@@ -0,0 +1,21 @@
+#include "trafego.h"
+
+double trafego_intervalo(const ConfigTrafego* t, Aleatorio* rng, int andar)
+{
+    double intervalo = t->intervalo_min + (t->intervalo_max - t->intervalo_min) * aleatorio_uniforme(rng);
+    if (t->perfil == PERFIL_SUBIDA && andar == 0)
+        intervalo /= t->fator_pico;
+    return intervalo;
+}
+
+int trafego_destino(const ConfigTrafego* t, Aleatorio* rng, int origem, int n_andares)
+{
+    if (t->perfil == PERFIL_DESCIDA && origem != 0 && aleatorio_uniforme(rng) < 1.0 - 1.0 / t->fator_pico)
+        return 0;
+
+    int destino;
+    do {
+        destino = aleatorio_inteiro(rng, n_andares);
+    } while (destino == origem);
+    return destino;
+}
@@ -0,0 +1,17 @@
+#ifndef TRAFEGO_H
+#define TRAFEGO_H
+
+#include "aleatorio.h"
+#include "config.h"
+
+/* === PERFIL DE TRAFEGO === */
+// Sorteios de chegada e destino das chamadas de um andar, usados pelo motor com
+// threads e pelo motor deterministico (mesma sequencia para a mesma semente)
+
+// Intervalo ate a proxima chamada do andar
+double trafego_intervalo(const ConfigTrafego* t, Aleatorio* rng, int andar);
+
+// Destino de uma nova chamada (sempre diferente da origem)
+int trafego_destino(const ConfigTrafego* t, Aleatorio* rng, int origem, int n_andares);
+
+#endif
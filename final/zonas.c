@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "zonas.h"
+
+#define TRUE 1
+#define FALSE 0
+
+
+typedef struct
+{
+    Zona zonas[MAX_ZONAS];
+    int n_zonas;
+    int* zona_elevador;     // Zona de cada elevador (-1 se nenhuma)
+    int n_elevadores_zonas;
+} EstadoZonas;
+
+
+/* === VARIAVEIS GLOBAIS === */
+// Instancia do processo; zonas_isolar_thread troca a da thread chamadora por uma privada
+static EstadoZonas estado_processo;
+static __thread EstadoZonas estado_thread;
+static __thread EstadoZonas* estado = &estado_processo;
+
+
+/* === CICLO DE VIDA === */
+void zonas_isolar_thread(void)
+{
+    estado = &estado_thread;
+}
+
+void zonas_iniciar(int n_elevadores)
+{
+    estado->zona_elevador = malloc(n_elevadores * sizeof(int));
+    if (estado->zona_elevador == NULL) {
+        printf("Erro: sem memoria para a tabela de zonas\n");
+        exit(1);
+    }
+    for (int i = 0; i < n_elevadores; i++)
+        estado->zona_elevador[i] = -1;
+    estado->n_elevadores_zonas = n_elevadores;
+    estado->n_zonas = 0;
+}
+
+void zonas_finalizar(void)
+{
+    for (int z = 0; z < estado->n_zonas; z++)
+        free(estado->zonas[z].elevadores);
+    free(estado->zona_elevador);
+    estado->zona_elevador = NULL;
+    estado->n_zonas = 0;
+}
+
+int zonas_adicionar(int andar_min, int andar_max, int andar_transferencia, const int* elevadores, int n)
+{
+    if (estado->n_zonas == MAX_ZONAS || n <= 0 || andar_min > andar_max)
+        return -1;
+
+    Zona* z = &estado->zonas[estado->n_zonas];
+    z->elevadores = malloc(n * sizeof(int));
+    if (z->elevadores == NULL)
+        return -1;
+    memcpy(z->elevadores, elevadores, n * sizeof(int));
+    z->n_elevadores = n;
+    z->andar_min = andar_min;
+    z->andar_max = andar_max;
+    z->andar_transferencia = andar_transferencia;
+
+    for (int k = 0; k < n; k++) {
+        if (elevadores[k] >= 0 && elevadores[k] < estado->n_elevadores_zonas)
+            estado->zona_elevador[elevadores[k]] = estado->n_zonas;
+    }
+    return estado->n_zonas++;
+}
+
+void zonas_configurar_uniforme(int n_andares, int n_elevadores, int n_zonas_pedidas)
+{
+    // Cada zona precisa de ao menos um elevador e um andar proprio
+    if (n_zonas_pedidas > n_elevadores)
+        n_zonas_pedidas = n_elevadores;
+    if (n_zonas_pedidas > n_andares - 1)
+        n_zonas_pedidas = n_andares - 1;
+    if (n_zonas_pedidas > MAX_ZONAS)
+        n_zonas_pedidas = MAX_ZONAS;
+
+    // Zona unica: todos os elevadores atendem todos os andares
+    if (n_zonas_pedidas <= 1) {
+        int ids[n_elevadores];
+        for (int i = 0; i < n_elevadores; i++)
+            ids[i] = i;
+        zonas_adicionar(0, n_andares - 1, 0, ids, n_elevadores);
+        return;
+    }
+
+    int andares_acima = n_andares - 1;
+    for (int k = 0; k < n_zonas_pedidas; k++) {
+        int primeiro_elev = k * n_elevadores / n_zonas_pedidas;
+        int ultimo_elev = (k + 1) * n_elevadores / n_zonas_pedidas;
+        int ids[n_elevadores];
+        for (int i = primeiro_elev; i < ultimo_elev; i++)
+            ids[i - primeiro_elev] = i;
+
+        int andar_min = 1 + k * andares_acima / n_zonas_pedidas;
+        int andar_max = (k + 1) * andares_acima / n_zonas_pedidas;
+        zonas_adicionar(andar_min, andar_max, 0, ids, ultimo_elev - primeiro_elev);
+    }
+}
+
+
+/* === CONSULTAS === */
+int zonas_total(void)
+{
+    return estado->n_zonas;
+}
+
+const Zona* zonas_obter(int z)
+{
+    return &estado->zonas[z];
+}
+
+int zonas_cobre(int z, int andar)
+{
+    const Zona* zona = &estado->zonas[z];
+    return (andar >= zona->andar_min && andar <= zona->andar_max) || andar == zona->andar_transferencia;
+}
+
+int zonas_do_elevador(int id)
+{
+    return estado->zona_elevador[id];
+}
+
+
+/* === ROTEAMENTO ENTRE ZONAS === */
+int zonas_proximo_trecho(int origem, int destino, Trecho* t)
+{
+    t->origem = origem;
+
+    // Viagem direta: alguma zona atende origem e destino
+    for (int z = 0; z < estado->n_zonas; z++) {
+        if (zonas_cobre(z, origem) && zonas_cobre(z, destino)) {
+            t->destino = destino;
+            t->zona = z;
+            return TRUE;
+        }
+    }
+
+    // Transferencia: andar atendido pela zona da origem e pela zona do destino
+    for (int zo = 0; zo < estado->n_zonas; zo++) {
+        if (!zonas_cobre(zo, origem))
+            continue;
+        for (int zd = 0; zd < estado->n_zonas; zd++) {
+            if (!zonas_cobre(zd, destino))
+                continue;
+
+            int transferencia = estado->zonas[zd].andar_transferencia;
+            if (!zonas_cobre(zo, transferencia))
+                transferencia = estado->zonas[zo].andar_transferencia;
+            if (transferencia != origem && zonas_cobre(zd, transferencia) && zonas_cobre(zo, transferencia)) {
+                t->destino = transferencia;
+                t->zona = zo;
+                return TRUE;
+            }
+        }
+    }
+
+    // Sem andar em comum: desce ate o andar de transferencia da zona da origem
+    for (int zo = 0; zo < estado->n_zonas; zo++) {
+        if (zonas_cobre(zo, origem) && estado->zonas[zo].andar_transferencia != origem) {
+            t->destino = estado->zonas[zo].andar_transferencia;
+            t->zona = zo;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
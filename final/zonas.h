@@ -0,0 +1,49 @@
+#ifndef ZONAS_H
+#define ZONAS_H
+
+/* === ZONAS (SETORES) DA FROTA === */
+#define MAX_ZONAS 16
+
+// Zona: faixa de andares atendida por um subconjunto dos elevadores.
+// O andar de transferencia (lobby ou sky lobby) tambem e atendido pela zona.
+typedef struct
+{
+    int andar_min;
+    int andar_max;
+    int andar_transferencia;
+    int* elevadores;      // Ids dos elevadores da zona
+    int n_elevadores;
+} Zona;
+
+// Trecho de uma viagem dentro de uma unica zona
+typedef struct
+{
+    int origem;
+    int destino;
+    int zona;
+} Trecho;
+
+void zonas_iniciar(int n_elevadores);
+void zonas_finalizar(void);
+
+// A partir daqui, a thread chamadora usa um estado proprio do modulo (vazio ate o
+// zonas_iniciar). Sem isso, todas as threads compartilham o estado do processo.
+void zonas_isolar_thread(void);
+
+// Adiciona uma zona; retorna o indice dela ou -1 em caso de erro
+int zonas_adicionar(int andar_min, int andar_max, int andar_transferencia, const int* elevadores, int n);
+
+// Divide os andares acima do terreo em n_zonas faixas contiguas, com o terreo como
+// andar de transferencia de todas, e reparte os elevadores igualmente entre elas
+void zonas_configurar_uniforme(int n_andares, int n_elevadores, int n_zonas);
+
+int zonas_total(void);
+const Zona* zonas_obter(int z);
+int zonas_cobre(int z, int andar);
+int zonas_do_elevador(int id);
+
+// Calcula o proximo trecho da viagem origem -> destino. Se nenhuma zona atende os dois
+// andares, o trecho termina num andar de transferencia. Retorna FALSE se nao ha rota.
+int zonas_proximo_trecho(int origem, int destino, Trecho* t);
+
+#endif